@@ -69,7 +69,7 @@ public:
 
             if (enable)
             {
-                Config::stepper_trk::moveTo(STEPPER_SPEED_TRACKING, transmit(limit_max));
+                Config::stepper::template moveTo<Config::PROFILE_TRACKING>(STEPPER_SPEED_TRACKING, transmit(limit_max));
                 _recentTrackingStartTime = timestamp;
             }
             else
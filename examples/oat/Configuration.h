@@ -5,6 +5,7 @@
 #include "IntervalInterrupt.h"
 #include "Driver.h"
 #include "Stepper.h"
+#include "RampSet.h"
 
 // CONFIGURATION
 #define RA_TRANSMISSION 35.46611505122143f
@@ -68,11 +69,14 @@ namespace config
         using ramp_slew = AccelerationRamp<256, interrupt::FREQ, SPEED_SLEWING.mrad_u32(), ACCELERATION.mrad_u32()>;
         using ramp_trk = AccelerationRamp<2, interrupt::FREQ, SPEED_TRACKING.mrad_u32(), SPEED_TRACKING.mrad_u32()>;
 
-        using stepper_slew = Stepper<interrupt, driver, ramp_slew>;
-        using stepper_trk = Stepper<interrupt, driver, ramp_trk>;
+        using ramps = RampSet<ramp_slew, ramp_trk>;
+        constexpr static uint8_t PROFILE_SLEWING = 0;
+        constexpr static uint8_t PROFILE_TRACKING = 1;
 
-        // constexpr static float SPEED_SLEWING_SPS = SPEED_SLEWING / stepper_slew::ANGLE_PER_STEP;
-        // constexpr static float SPEED_TRACKING_SPS = SPEED_TRACKING / stepper_trk::ANGLE_PER_STEP;
+        using stepper = Stepper<interrupt, driver, ramps>;
+
+        // constexpr static float SPEED_SLEWING_SPS = SPEED_SLEWING / stepper::ANGLE_PER_STEP;
+        // constexpr static float SPEED_TRACKING_SPS = SPEED_TRACKING / stepper::ANGLE_PER_STEP;
     };
 
     struct Dec
@@ -96,10 +100,12 @@ namespace config
         using interrupt = IntervalInterrupt<Timer::TIMER_4>;
         using driver = Driver<Pin<DEC_STEP_PIN>, Pin<DEC_DIR_PIN>>;
         
-        using stepper_slew = Stepper<interrupt, driver, Ra::ramp_slew>;
-        using stepper_trk = Stepper<interrupt, driver, Ra::ramp_trk>;
+        constexpr static uint8_t PROFILE_SLEWING = Ra::PROFILE_SLEWING;
+        constexpr static uint8_t PROFILE_TRACKING = Ra::PROFILE_TRACKING;
+
+        using stepper = Stepper<interrupt, driver, Ra::ramps>;
 
-        // constexpr static float SPEED_SLEWING_SPS = SPEED_SLEWING / stepper_slew::ANGLE_PER_STEP;
+        // constexpr static float SPEED_SLEWING_SPS = SPEED_SLEWING / stepper::ANGLE_PER_STEP;
     };
 
     // struct AZ
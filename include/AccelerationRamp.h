@@ -3,6 +3,7 @@
 
 #include <stdint.h> // NOLINT(modernize-deprecated-headers)
 #include <math.h> // NOLINT(modernize-deprecated-headers)
+#include "FixedSpeed.h"
 #include "NewtonRaphson.h"
 
 template<uint16_t N>
@@ -16,6 +17,21 @@ struct Intervals {
     constexpr inline __attribute__((always_inline)) const uint32_t &operator[](const unsigned int i) const {
         return data[i];
     }
+
+    /// @brief Highest stair whose interval is not shorter than `interval`, by binary search.
+    constexpr uint16_t stairFor(const uint32_t interval) const {
+        uint16_t lo = 0;
+        uint16_t hi = N - 1;
+        while (lo < hi) {
+            const auto mid = static_cast<uint16_t>((lo + hi + 1) / 2);
+            if (data[mid] >= interval) {
+                lo = mid;
+            } else {
+                hi = static_cast<uint16_t>(mid - 1);
+            }
+        }
+        return lo;
+    }
 };
 
 /// @brief Helper for acceleration ramp calculations based on AVR466.
@@ -26,8 +42,11 @@ struct Intervals {
 /// @tparam SPR stepper steps per revolution (incl. microstepping)
 /// @tparam MAX_SPEED_mRAD maximal possible speed in mrad/s
 /// @tparam ACCELERATION_mRAD maximal possible speed in mrad/s/s
+/// @tparam COALESCE_SPEED speed in steps/s from which on several steps are emitted per interrupt, 0 disables it
+/// @tparam COALESCE_BURST steps emitted per interrupt at or above `COALESCE_SPEED`, the interrupt busy-waits
+/// between them and so keeps other interrupts off for (COALESCE_BURST - 1) / COALESCE_BURST of the time
 ///
-template<uint16_t STAIRS, uint32_t T_FREQ, uint32_t MAX_SPEED, uint32_t ACCELERATION>
+template<uint16_t STAIRS, uint32_t T_FREQ, uint32_t MAX_SPEED, uint32_t ACCELERATION, uint32_t COALESCE_SPEED = 0, uint8_t COALESCE_BURST = 2>
 class AccelerationRamp {
     template<typename T>
     constexpr static inline __attribute__((always_inline)) bool is_pow2(const T value) {
@@ -96,6 +115,16 @@ public:
     static_assert(STEPS_PER_STAIR <= 128, "Amount of steps per stair has to be at most 128");
     static_assert(is_pow2(STEPS_PER_STAIR), "Amount of steps per stair has to be power of 2");
 
+    /// @brief Intervals up to this many ticks are served by one interrupt per `COALESCE_STEPS` steps.
+    /// Zero disables coalescing.
+    constexpr static uint32_t COALESCE_INTERVAL = (COALESCE_SPEED > 0) ? T_FREQ / COALESCE_SPEED : 0;
+
+    constexpr static uint8_t COALESCE_STEPS = COALESCE_BURST;
+
+    static_assert(COALESCE_BURST > 0 && is_pow2(COALESCE_BURST), "Steps per interrupt have to be a power of 2");
+    static_assert(COALESCE_SPEED == 0 || COALESCE_BURST <= STEPS_PER_STAIR, "A burst must not span several stairs");
+    static_assert(COALESCE_INTERVAL * COALESCE_BURST <= UINT16_MAX, "A burst has to fit into one 16 bit timer period");
+
     static constexpr inline __attribute__((always_inline)) uint32_t interval(const uint16_t stair) {
         return intervals[stair];
     }
@@ -104,6 +133,29 @@ public:
         return static_cast<uint32_t>(T_FREQ / absf(sps));
     }
 
+    static constexpr inline __attribute__((always_inline)) uint32_t getIntervalForSpeed(const FixedSpeed speed) {
+        return speed.interval<T_FREQ>();
+    }
+
+    /// @brief Fraction of a tick truncated by `getIntervalForSpeed()`, in 1/65536 ticks.
+    static constexpr inline uint16_t getIntervalFractionForSpeed(const float sps) {
+        const float exact = T_FREQ / absf(sps);
+        return static_cast<uint16_t>((exact - static_cast<float>(static_cast<uint32_t>(exact))) * 65536.0f);
+    }
+
+    static constexpr inline uint16_t getIntervalFractionForSpeed(const FixedSpeed speed) {
+        return speed.intervalFraction<T_FREQ>();
+    }
+
+    /// @brief Integer counterpart of `maxAccelStairs()` for an interval from `getIntervalForSpeed()`.
+    ///
+    /// Returns the highest stair that is not faster than `interval`. Near stair boundaries this can
+    /// be one stair below the result of the float formula, which may pick a stair slightly faster
+    /// than the requested speed.
+    static constexpr inline uint16_t maxAccelStairsForInterval(const uint32_t interval) {
+        return intervals.stairFor(interval);
+    }
+
     static constexpr inline __attribute__((always_inline)) uint16_t maxAccelStairs(const float sps) {
         const float speed = absf(sps);
 
@@ -140,10 +192,28 @@ public:
         return static_cast<uint32_t>(T_FREQ / absf(sps));
     }
 
+    static constexpr inline __attribute__((always_inline)) uint32_t getIntervalForSpeed(const FixedSpeed speed) {
+        return speed.interval<T_FREQ>();
+    }
+
+    /// @brief Fraction of a tick truncated by `getIntervalForSpeed()`, in 1/65536 ticks.
+    static constexpr inline uint16_t getIntervalFractionForSpeed(const float sps) {
+        const float exact = T_FREQ / absf(sps);
+        return static_cast<uint16_t>((exact - static_cast<float>(static_cast<uint32_t>(exact))) * 65536.0f);
+    }
+
+    static constexpr inline uint16_t getIntervalFractionForSpeed(const FixedSpeed speed) {
+        return speed.intervalFraction<T_FREQ>();
+    }
+
     static constexpr inline __attribute__((always_inline)) uint16_t maxAccelStairs(const float sps) {
         return 0;
     }
 
+    static constexpr inline __attribute__((always_inline)) uint16_t maxAccelStairsForInterval([[maybe_unused]] const uint32_t interval) {
+        return 0;
+    }
+
 };
 
 #endif // ACCELERATION_RAMP_H
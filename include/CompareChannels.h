@@ -0,0 +1,450 @@
+#pragma once
+
+#include <stdint.h> // NOLINT(modernize-deprecated-headers)
+
+#include "IntervalInterrupt.h"
+
+/**
+ * @brief Three interval timers on the compare units A, B and C of one free-running 16 bit timer.
+ *
+ * The counter never stops or clears. Each channel keeps a 32 bit deadline on the counter extended
+ * by the overflow interrupt, and its own compare unit fires once that deadline is reached. The
+ * handler of a channel schedules the next deadline as `deadline += interval`, so a channel does
+ * not drift no matter how late its interrupt ran, exactly like `TimerMultiplexer`. Unlike there,
+ * every channel has its own compare unit and vector, so channels never wait for a software
+ * dispatcher. Colliding deadlines only cost the hardware priority of the vectors: A before B
+ * before C before the overflow.
+ *
+ * Intervals longer than one overflow period arm their compare unit from the overflow interrupt
+ * of the period they end in. The overflow interrupt fires every 65536 ticks while the timer runs,
+ * 244 times per second at 16 MHz, and costs a few dozen cycles when no deadline ends in the new
+ * period.
+ *
+ * @tparam TIMER Register access: `FREQ`, `start()`, `count()`, `overflowPending()`,
+ * `setCompare(channel, value)`, `enableCompare(channel)`, which also clears a stale compare flag,
+ * `disableCompare(channel)`, `lock()` and `unlock(state)`.
+ */
+template <typename TIMER>
+class CompareChannels
+{
+public:
+    CompareChannels() = delete;
+
+    constexpr static uint8_t CHANNELS = 3;
+
+    constexpr static uint32_t FREQ = TIMER::FREQ;
+
+    constexpr static uint32_t MAX_INTERVAL = static_cast<uint32_t>(INT32_MAX);
+
+private:
+    constexpr static uint8_t NONE = 0xFF;
+
+    struct Channel
+    {
+        timer_callback callback;
+        uint32_t base; ///< Deadline the current interval is counted from.
+        uint32_t deadline; ///< Next due time on the extended counter.
+        bool active;
+        bool waiting; ///< Started while held, the first interval counts from `release()`.
+    };
+
+    static Channel channels[CHANNELS];
+    static volatile uint16_t high; ///< Upper 16 bits of the extended counter.
+    static volatile uint8_t serving; ///< Channel whose callback runs, `NONE` outside of callbacks.
+    static bool held; ///< Channels started now wait for `release()`.
+    static bool initialized;
+
+    static inline __attribute__((always_inline)) bool due(const uint8_t channel, const uint32_t time)
+    {
+        return static_cast<int32_t>(time - channels[channel].deadline) >= 0;
+    }
+
+    /**
+     * @brief Arm the compare unit of `channel` for its deadline.
+     *
+     * @return `true` if the deadline has already passed, the caller has to serve it right away.
+     */
+    static inline bool arm(const uint8_t channel)
+    {
+        const uint32_t deadline = channels[channel].deadline;
+        TIMER::setCompare(channel, static_cast<uint16_t>(deadline));
+
+        const uint32_t time = now();
+        if (static_cast<uint16_t>(deadline >> 16) == static_cast<uint16_t>(time >> 16))
+        {
+            TIMER::enableCompare(channel);
+        }
+        else
+        {
+            // enabled by the overflow that starts the deadline's period
+            TIMER::disableCompare(channel);
+        }
+
+        return due(channel, now());
+    }
+
+    /**
+     * @brief Run the callback of `channel` until its next deadline lies in the future.
+     */
+    static inline void serve(const uint8_t channel)
+    {
+        Channel &c = channels[channel];
+        do
+        {
+            // the next interval starts at the deadline, not at the moment it is served
+            const uint32_t interval = c.deadline - c.base;
+            c.base = c.deadline;
+            c.deadline = c.base + interval;
+
+            serving = channel;
+            c.callback();
+            serving = NONE;
+
+            if (!c.active)
+            {
+                TIMER::disableCompare(channel);
+                return;
+            }
+        } while (arm(channel));
+    }
+
+public:
+    /**
+     * @brief Start the free-running counter. Further calls are ignored.
+     */
+    static void init()
+    {
+        if (!initialized)
+        {
+            initialized = true;
+            high = 0;
+            serving = NONE;
+            TIMER::start();
+        }
+    }
+
+    /**
+     * @brief Extended 32 bit count of the timer.
+     */
+    static inline uint32_t now()
+    {
+        const uint8_t state = TIMER::lock();
+        const uint16_t low = TIMER::count();
+        uint16_t upper = high;
+        // an overflow whose interrupt has not run yet is not counted in `high`
+        if (TIMER::overflowPending() && low < 0x8000)
+        {
+            upper++;
+        }
+        TIMER::unlock(state);
+        return (static_cast<uint32_t>(upper) << 16) | low;
+    }
+
+    static inline __attribute__((always_inline)) void setCallback(const uint8_t channel, const timer_callback fn)
+    {
+        channels[channel].callback = fn;
+    }
+
+    /**
+     * @brief Set the interval of `channel` and start it if it is stopped.
+     *
+     * A stopped channel counts its first interval from now. A running channel counts it from its
+     * previous deadline, like a CTC timer whose compare value is changed.
+     */
+    static void setInterval(const uint8_t channel, uint32_t value)
+    {
+        if (value > MAX_INTERVAL)
+        {
+            value = MAX_INTERVAL;
+        }
+
+        const uint8_t state = TIMER::lock();
+
+        Channel &c = channels[channel];
+        if (!c.active)
+        {
+            c.base = now();
+            c.active = true;
+            c.waiting = held;
+        }
+        c.deadline = c.base + value;
+
+        if (c.waiting)
+        {
+            TIMER::unlock(state);
+            return;
+        }
+
+        // inside its own callback the channel is armed by `serve()` afterwards
+        if (serving != channel && arm(channel))
+        {
+            serve(channel);
+        }
+
+        TIMER::unlock(state);
+    }
+
+    static void stop(const uint8_t channel)
+    {
+        const uint8_t state = TIMER::lock();
+        channels[channel].active = false;
+        channels[channel].waiting = false;
+        TIMER::disableCompare(channel);
+        TIMER::unlock(state);
+    }
+
+    /**
+     * @brief Do not let a channel that starts from now on run before `release()`, see `SyncStart`.
+     *
+     * The counter keeps running for the channels that are already active.
+     */
+    static inline __attribute__((always_inline)) void hold()
+    {
+        held = true;
+    }
+
+    /**
+     * @brief Count the first interval of every channel started while held from now.
+     *
+     * The channels share one counter, so the first deadlines of channels released together are
+     * counted from the same tick.
+     */
+    static void release()
+    {
+        const uint8_t state = TIMER::lock();
+        held = false;
+
+        const uint32_t time = now();
+        uint8_t released = 0;
+        for (uint8_t channel = 0; channel < CHANNELS; channel++)
+        {
+            Channel &c = channels[channel];
+            if (c.waiting)
+            {
+                c.deadline = time + (c.deadline - c.base);
+                c.base = time;
+                c.waiting = false;
+                released |= (1U << channel);
+            }
+        }
+        for (uint8_t channel = 0; channel < CHANNELS; channel++)
+        {
+            // a callback served first may have stopped a later channel again
+            if ((released & (1U << channel)) != 0 && channels[channel].active && arm(channel))
+            {
+                serve(channel);
+            }
+        }
+
+        TIMER::unlock(state);
+    }
+
+    /**
+     * @brief Ticks since the deadline `channel` was last served.
+     */
+    static inline uint32_t elapsed(const uint8_t channel)
+    {
+        return now() - channels[channel].base;
+    }
+
+    /**
+     * @brief Compare match of `channel`, called from its vector.
+     */
+    static inline __attribute__((always_inline)) void handle_compare(const uint8_t channel)
+    {
+        if (channels[channel].active && !channels[channel].waiting && due(channel, now()))
+        {
+            serve(channel);
+        }
+    }
+
+    /**
+     * @brief Overflow of the counter: arm every channel whose deadline ends in the new period.
+     */
+    static inline void handle_overflow()
+    {
+        high++;
+
+        for (uint8_t channel = 0; channel < CHANNELS; channel++)
+        {
+            const Channel &c = channels[channel];
+            if (c.active && !c.waiting && serving != channel && static_cast<uint16_t>(c.deadline >> 16) == high &&
+                arm(channel))
+            {
+                serve(channel);
+            }
+        }
+    }
+};
+
+template <typename TIMER>
+typename CompareChannels<TIMER>::Channel CompareChannels<TIMER>::channels[CHANNELS] = {};
+
+template <typename TIMER>
+volatile uint16_t CompareChannels<TIMER>::high = 0;
+
+template <typename TIMER>
+volatile uint8_t CompareChannels<TIMER>::serving = CompareChannels<TIMER>::NONE;
+
+template <typename TIMER>
+bool CompareChannels<TIMER>::held = false;
+
+template <typename TIMER>
+bool CompareChannels<TIMER>::initialized = false;
+
+/**
+ * @brief `IntervalInterrupt`-compatible view of one channel of `CompareChannels`.
+ *
+ * Can be passed to `Stepper` as its `INTERRUPT` parameter, so up to three independently timed
+ * steppers share one hardware timer. Every channel has to be used by exactly one stepper.
+ */
+template <typename CHANNELS, uint8_t CHANNEL>
+class ChannelInterrupt
+{
+    static_assert(CHANNEL < CHANNELS::CHANNELS, "The timer has compare channels 0 (A) to 2 (C)");
+
+public:
+    ChannelInterrupt() = delete;
+
+    constexpr static int ID = CHANNEL;
+
+    constexpr static uint32_t FREQ = CHANNELS::FREQ;
+
+    static void init()
+    {
+        CHANNELS::init();
+    }
+
+    static inline __attribute__((always_inline)) void setCallback(timer_callback fn)
+    {
+        CHANNELS::setCallback(CHANNEL, fn);
+    }
+
+    static inline __attribute__((always_inline)) void setInterval(uint32_t value)
+    {
+        CHANNELS::setInterval(CHANNEL, value);
+    }
+
+    static inline __attribute__((always_inline)) void stop()
+    {
+        CHANNELS::stop(CHANNEL);
+    }
+
+    static inline __attribute__((always_inline)) uint32_t elapsed()
+    {
+        return CHANNELS::elapsed(CHANNEL);
+    }
+
+    static inline __attribute__((always_inline)) void hold()
+    {
+        CHANNELS::hold();
+    }
+
+    static inline __attribute__((always_inline)) void release()
+    {
+        CHANNELS::release();
+    }
+};
+
+#if defined(ARDUINO_ARCH_AVR)
+
+/**
+ * @brief Register access of `CompareChannels` on a 16 bit timer of the ATmega2560.
+ *
+ * The timer runs in normal mode at the CPU clock. OCRnB and OCRnC follow OCRnA in the data space,
+ * their interrupt enable and flag bits follow OCIEnA and OCFnA.
+ */
+template <Timer T>
+struct CompareChannels_AVR
+{
+    using Registers = IntervalInterrupt_AVR<T>;
+
+    constexpr static uint32_t FREQ = F_CPU;
+
+    static void start()
+    {
+        cli();
+        *Registers::TCCRA() = 0;
+        *Registers::TCCRB() = 0;
+        *Registers::TCNT() = 0;
+        *Registers::TIFR() = 0xFF;    // clear all pending flags
+        *Registers::TIMSK() = bit(0); // overflow interrupt only
+        *Registers::TCCRB() = 1;      // normal mode, prescaler 1
+        sei();
+    }
+
+    static inline __attribute__((always_inline)) uint16_t count()
+    {
+        return *Registers::TCNT();
+    }
+
+    static inline __attribute__((always_inline)) bool overflowPending()
+    {
+        return (*Registers::TIFR() & bit(0)) != 0;
+    }
+
+    static inline __attribute__((always_inline)) void setCompare(const uint8_t channel, const uint16_t value)
+    {
+        *(Registers::OCRA() + channel) = value;
+    }
+
+    static inline __attribute__((always_inline)) void enableCompare(const uint8_t channel)
+    {
+        // flags are cleared by writing a one
+        *Registers::TIFR() = bit(1 + channel);
+        *Registers::TIMSK() |= bit(1 + channel);
+    }
+
+    static inline __attribute__((always_inline)) void disableCompare(const uint8_t channel)
+    {
+        *Registers::TIMSK() &= ~bit(1 + channel);
+    }
+
+    static inline __attribute__((always_inline)) uint8_t lock()
+    {
+        const uint8_t sreg = SREG;
+        cli();
+        return sreg;
+    }
+
+    static inline __attribute__((always_inline)) void unlock(const uint8_t sreg)
+    {
+        SREG = sreg;
+    }
+};
+
+/// Channel `CHANNEL` (0 = A, 1 = B, 2 = C) of AVR timer `T` as a `Stepper` interrupt.
+template <Timer T, uint8_t CHANNEL>
+using TimerChannel = ChannelInterrupt<CompareChannels<CompareChannels_AVR<T>>, CHANNEL>;
+
+/**
+ * @brief Route the interrupts of AVR timer `x` to its three `TimerChannel`s.
+ *
+ * The timer can not be used by `STEPPER_USE_TIMER` or `STEPPER_USE_MULTIPLEXED_TIMER` at the same
+ * time. Unused channels cost nothing but their idle vector.
+ */
+#define STEPPER_USE_TIMER_CHANNELS(x)                                                    \
+    ISR(TIMER##x##_OVF_vect)                                                             \
+    {                                                                                    \
+        CompareChannels<CompareChannels_AVR<Timer::TIMER_##x>>::handle_overflow();       \
+    }                                                                                    \
+    ISR(TIMER##x##_COMPA_vect)                                                           \
+    {                                                                                    \
+        INTERRUPT_TIMING_START();                                                        \
+        CompareChannels<CompareChannels_AVR<Timer::TIMER_##x>>::handle_compare(0);       \
+        INTERRUPT_TIMING_END();                                                          \
+    }                                                                                    \
+    ISR(TIMER##x##_COMPB_vect)                                                           \
+    {                                                                                    \
+        INTERRUPT_TIMING_START();                                                        \
+        CompareChannels<CompareChannels_AVR<Timer::TIMER_##x>>::handle_compare(1);       \
+        INTERRUPT_TIMING_END();                                                          \
+    }                                                                                    \
+    ISR(TIMER##x##_COMPC_vect)                                                           \
+    {                                                                                    \
+        INTERRUPT_TIMING_START();                                                        \
+        CompareChannels<CompareChannels_AVR<Timer::TIMER_##x>>::handle_compare(2);       \
+        INTERRUPT_TIMING_END();                                                          \
+    }
+
+#endif
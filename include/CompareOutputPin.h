@@ -0,0 +1,129 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Step pin driven by output compare unit A of the 16 bit timer that runs the stepper.
+ *
+ * The timer sets the pin itself on every compare match, so the rising edge, which is the one step
+ * drivers latch on, is placed by hardware exactly at the programmed interval. `pulse()` is called by
+ * the ISR that the same compare match triggers and only ends the pulse, so interrupt latency
+ * stretches the pulse width but never moves the step. Pair it with any `Driver`:
+ *
+ *     using step_pin = CompareOutputPin<IntervalInterrupt_AVR<Timer::TIMER_5>>; // OC5A, pin 46
+ *     using stepper = Stepper<IntervalInterrupt<Timer::TIMER_5>, Driver<step_pin, Pin<47>>, ramp>;
+ *
+ * Every step has to come from a compare match of that timer: the pin cannot be used with ramps that
+ * emit several steps per interrupt.
+ *
+ * @tparam TIMER Register bank of the timer, `IntervalInterrupt_AVR<T>` on AVR. It provides
+ * `TCCRA()`, `TCCRC()`, `initCompareOutput()` and `com_bits`, the output mode the backend restores
+ * whenever compare matches count as steps again.
+ */
+template <typename TIMER>
+class CompareOutputPin
+{
+public:
+    CompareOutputPin() = delete;
+
+    constexpr static uint8_t COM_MASK = 0b11 << 6; ///< COMnA1:0 in TCCRnA
+    constexpr static uint8_t COM_CLEAR = 0b10 << 6; ///< clear OCnA on compare match
+    constexpr static uint8_t COM_SET = 0b11 << 6; ///< set OCnA on compare match
+    constexpr static uint8_t FOC = 1 << 7; ///< FOCnA in TCCRnC, strobes the compare output action
+
+    static void init()
+    {
+        TIMER::initCompareOutput();
+        TIMER::com_bits = COM_SET;
+        *TIMER::TCCRA() = (*TIMER::TCCRA() & ~COM_MASK) | COM_SET;
+        low();
+    }
+
+    /**
+     * @brief End the pulse the compare match started.
+     */
+    static inline __attribute__((always_inline)) void pulse()
+    {
+        low();
+    }
+
+    static inline __attribute__((always_inline)) void high()
+    {
+        force(COM_SET);
+    }
+
+    static inline __attribute__((always_inline)) void low()
+    {
+        force(COM_CLEAR);
+    }
+
+private:
+    /**
+     * @brief Apply `action` to the pin right now and restore the output mode.
+     *
+     * A forced compare neither clears the counter nor raises the interrupt flag. It also works while
+     * the backend has the output disconnected to count overflows, the level is then latched for the
+     * next reconnect.
+     */
+    static inline __attribute__((always_inline)) void force(const uint8_t action)
+    {
+        const uint8_t tccra = *TIMER::TCCRA();
+        *TIMER::TCCRA() = (tccra & ~COM_MASK) | action;
+        *TIMER::TCCRC() = FOC;
+        *TIMER::TCCRA() = tccra;
+    }
+};
+
+/**
+ * @brief Step pin driven by compare channel 1 of the STM32 timer that runs the stepper.
+ *
+ * The STM32 counterpart of `CompareOutputPin`. `internal::DriftFreeTimer` lets the channel raise
+ * the pin at the update event that ends an interval, the intermediate periods of a split interval
+ * leave it alone. The rising edge therefore lies exactly on the drift-free schedule, and `pulse()`
+ * only ends the pulse:
+ *
+ *     using step_pin = CompareOutputPin_STM32<IntervalInterrupt_STM32<Timer::TIMER_2>, PA0>; // TIM2_CH1
+ *     using stepper = Stepper<IntervalInterrupt<Timer::TIMER_2>, Driver<step_pin, Pin<PA1>>, ramp>;
+ *
+ * The channel matches at a count of 0, so a move starts its counter at 1 and its first step comes
+ * one tick early. Like on AVR every step has to come from the timer, which rules out ramps that
+ * emit several steps per interrupt. Only general purpose timers are supported, the outputs of the
+ * advanced timers TIM1 and TIM8 are gated by their break unit.
+ *
+ * @tparam TIMER Hardware access of the timer, `IntervalInterrupt_STM32<T>`. It provides `Engine`
+ * and `initCompareOutput(pin)`, which routes the pin to channel 1.
+ * @tparam PIN Arduino pin number of TIMx_CH1.
+ */
+template <typename TIMER, uint32_t PIN>
+class CompareOutputPin_STM32
+{
+public:
+    CompareOutputPin_STM32() = delete;
+
+    static void init()
+    {
+        // the stepper initializes its driver first, the timer has to be clocked already
+        TIMER::Engine::init();
+        // the output is forced low before the pin is handed to the timer
+        TIMER::Engine::enableCompareOutput();
+        TIMER::initCompareOutput(PIN);
+    }
+
+    /**
+     * @brief End the pulse the update event started.
+     */
+    static inline __attribute__((always_inline)) void pulse()
+    {
+        low();
+    }
+
+    static inline __attribute__((always_inline)) void high()
+    {
+        TIMER::Engine::forceCompareOutput(true);
+    }
+
+    static inline __attribute__((always_inline)) void low()
+    {
+        TIMER::Engine::forceCompareOutput(false);
+    }
+};
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "IntervalInterrupt.h"
+
+namespace internal
+{
+    /**
+     * @brief Interval logic of an STM32 timer whose counter is never reset while a move runs.
+     *
+     * Every interval counts from the update event that ended the previous one. The handler of that
+     * event writes ARR for the period that is already running, so the latency of the interrupt does
+     * not add to the interval and a long move has no cumulative drift. ARR is written without
+     * preload, because the stepper always programs the period that has just started. If the counter
+     * is already past the new ARR, which only happens when the handler overran the interval, an
+     * update is forced right away instead of letting the counter wrap.
+     *
+     * A 32 bit counter (TIM2, TIM5 on most families) holds every practical interval in one period.
+     * On a 16 bit counter longer intervals are split into equal periods of at least 32768 ticks and
+     * only the last one calls the stepper, without swapping interrupt handlers.
+     *
+     * Compare channel 1 can drive the step pin, see `CompareOutputPin_STM32`. With CCR1 at 0 it
+     * matches at every update event, and it is only set to raise its output for the update event
+     * that ends an interval.
+     *
+     * @tparam TIM Hardware access: `Regs` with `CR1`, `SR`, `EGR`, `CNT`, `ARR`, `CCMR1`, `CCER` and
+     * `CCR1`, `regs()`, `wide()` for a 32 bit counter, `FREQ`, `init()` which routes the update
+     * interrupt to `handle_update()`, `resume()` and `pause()`.
+     */
+    template <typename TIM>
+    class DriftFreeTimer
+    {
+        static uint16_t periods;      ///< periods of the current interval, 1 unless it is split
+        static uint16_t periods_left; ///< periods of a split interval that are still to come
+        static uint32_t first;        ///< ticks of the first period
+        static uint32_t period;       ///< ticks of each further period
+        static bool held;             ///< a move started now waits for `release()`
+        static bool pending;          ///< a move was started while held
+        static bool compare_output;   ///< compare channel 1 drives the step pin
+
+    public:
+        DriftFreeTimer() = delete;
+
+        constexpr static uint32_t CR1_CEN = 1UL << 0;
+        constexpr static uint32_t SR_UIF = 1UL << 0;
+        constexpr static uint32_t EGR_UG = 1UL << 0;
+
+        constexpr static uint32_t CCMR1_OC1M = 0b111UL << 4;
+        constexpr static uint32_t OC1M_FROZEN = 0b000UL << 4; ///< a match leaves the output alone
+        constexpr static uint32_t OC1M_ACTIVE = 0b001UL << 4; ///< a match raises the output
+        constexpr static uint32_t OC1M_FORCE_LOW = 0b100UL << 4;
+        constexpr static uint32_t OC1M_FORCE_HIGH = 0b101UL << 4;
+        constexpr static uint32_t CCMR1_CC1S = 0b11UL;
+        constexpr static uint32_t CCER_CC1E = 1UL << 0;
+
+        constexpr static uint32_t FREQ = TIM::FREQ;
+
+        static volatile timer_callback callback;
+
+        static void init()
+        {
+            TIM::init();
+            // init may have raised an update to load the prescaler
+            stop();
+        }
+
+        static inline __attribute__((always_inline)) void setCallback(const timer_callback fn)
+        {
+            callback = fn;
+        }
+
+        static inline __attribute__((always_inline)) void setInterval(const uint32_t value)
+        {
+            auto *const tim = TIM::regs();
+
+            first = value;
+            periods = 1;
+            if (!TIM::wide() && value > 0x10000)
+            {
+                periods = static_cast<uint16_t>((value + 0xFFFF) >> 16);
+                period = value / periods;
+                first = value - period * (periods - 1);
+            }
+            periods_left = periods - 1;
+
+            if ((tim->CR1 & CR1_CEN) == 0)
+            {
+                // first interval of a move, the only time the counter starts from zero, or from
+                // one past the match of the step output, which makes the first step one tick early
+                tim->CNT = (compare_output && first > 1) ? 1 : 0;
+                tim->ARR = first - 1;
+                connect(periods == 1);
+                if (held)
+                {
+                    pending = true;
+                    return;
+                }
+                TIM::resume();
+                return;
+            }
+
+            tim->ARR = first - 1;
+            connect(periods == 1);
+            if (tim->CNT > first - 1)
+            {
+                tim->EGR = EGR_UG;
+            }
+        }
+
+        static inline __attribute__((always_inline)) void stop()
+        {
+            auto *const tim = TIM::regs();
+
+            TIM::pause();
+            connect(false);
+            tim->CNT = 0;
+            tim->SR = ~SR_UIF;
+            periods = 1;
+            periods_left = 0;
+            pending = false;
+        }
+
+        /**
+         * @brief Do not let a move that starts from now on run before `release()`, see `SyncStart`.
+         */
+        static inline __attribute__((always_inline)) void hold()
+        {
+            held = true;
+        }
+
+        /**
+         * @brief Start the counter of a move that was started while held.
+         */
+        static inline __attribute__((always_inline)) void release()
+        {
+            held = false;
+            if (pending)
+            {
+                pending = false;
+                TIM::resume();
+            }
+        }
+
+        /**
+         * @brief Make compare channel 1 the step output, see `CompareOutputPin_STM32`. Its output
+         * starts low.
+         */
+        static void enableCompareOutput()
+        {
+            auto *const tim = TIM::regs();
+
+            tim->CCR1 = 0;
+            tim->CCMR1 = (tim->CCMR1 & ~(CCMR1_OC1M | CCMR1_CC1S)) | OC1M_FORCE_LOW;
+            tim->CCMR1 = tim->CCMR1 & ~CCMR1_OC1M;
+            tim->CCER = tim->CCER | CCER_CC1E;
+            compare_output = true;
+        }
+
+        /**
+         * @brief Set the step output to `level` right now and restore its compare mode.
+         */
+        static inline __attribute__((always_inline)) void forceCompareOutput(const bool level)
+        {
+            auto *const tim = TIM::regs();
+
+            const uint32_t ccmr1 = tim->CCMR1;
+            tim->CCMR1 = (ccmr1 & ~CCMR1_OC1M) | (level ? OC1M_FORCE_HIGH : OC1M_FORCE_LOW);
+            tim->CCMR1 = ccmr1;
+        }
+
+        static inline __attribute__((always_inline)) uint32_t elapsed()
+        {
+            // the counter restarts at the update event
+            return TIM::regs()->CNT;
+        }
+
+        /**
+         * @brief Update interrupt: the next period of a split interval, or the end of the interval.
+         */
+        static inline __attribute__((always_inline)) void handle_update()
+        {
+            if (periods_left > 0)
+            {
+                periods_left--;
+                TIM::regs()->ARR = period - 1;
+                connect(periods_left == 0);
+                return;
+            }
+
+            if (periods > 1)
+            {
+                // the stepper repeats the interval unless it programs a new one
+                periods_left = periods - 1;
+                TIM::regs()->ARR = first - 1;
+                connect(false);
+            }
+
+            callback();
+        }
+
+    private:
+        /**
+         * @brief Let the next update event raise the step output, or keep it from doing so.
+         */
+        static inline __attribute__((always_inline)) void connect(const bool step)
+        {
+            if (compare_output)
+            {
+                auto *const tim = TIM::regs();
+                tim->CCMR1 = (tim->CCMR1 & ~CCMR1_OC1M) | (step ? OC1M_ACTIVE : OC1M_FROZEN);
+            }
+        }
+    };
+
+    template <typename TIM>
+    uint16_t DriftFreeTimer<TIM>::periods = 1;
+
+    template <typename TIM>
+    uint16_t DriftFreeTimer<TIM>::periods_left = 0;
+
+    template <typename TIM>
+    uint32_t DriftFreeTimer<TIM>::first = 0;
+
+    template <typename TIM>
+    uint32_t DriftFreeTimer<TIM>::period = 0;
+
+    template <typename TIM>
+    bool DriftFreeTimer<TIM>::held = false;
+
+    template <typename TIM>
+    bool DriftFreeTimer<TIM>::pending = false;
+
+    template <typename TIM>
+    bool DriftFreeTimer<TIM>::compare_output = false;
+
+    template <typename TIM>
+    volatile timer_callback DriftFreeTimer<TIM>::callback = nullptr;
+}
@@ -2,47 +2,112 @@
 
 #include <stdint.h>
 
-template <typename T_PIN_STEP, typename T_PIN_DIR>
+/**
+ * @brief When a `Driver` ends its step pulses.
+ */
+enum class StepPulse : uint8_t
+{
+    /// `step()` raises and lowers the step pin right away, the pulse is two port writes wide.
+    IMMEDIATE,
+    /// `step()` only raises the step pin. The stepper lowers it through `release()` at the start of
+    /// the next interrupt, so the pulse is high for almost the whole interval.
+    DEFERRED,
+    /// `step()` toggles the step pin, one port write per step. Only for drivers that step on both
+    /// edges, e.g. TMC2209 with `CHOPCONF.dedge` set.
+    DUAL_EDGE,
+};
+
+template <typename T_PIN_STEP, typename T_PIN_DIR, StepPulse PULSE = StepPulse::IMMEDIATE>
 class Driver
 {
 private:
     static bool isInverted;
+    static bool stepLevel; ///< Level of the step pin, only tracked for `StepPulse::DUAL_EDGE`.
 
 public:
     Driver() = delete;
 
+    using StepPin = T_PIN_STEP;
+    using DirPin = T_PIN_DIR;
+
+    constexpr static StepPulse PULSE_MODE = PULSE;
+
+    /// Whether the stepper has to call `release()` before every step.
+    constexpr static bool DEFERRED_PULSE = PULSE == StepPulse::DEFERRED;
+
+    /// Whether every edge of the step pin is a step. A pulse would then be two steps.
+    constexpr static bool DUAL_EDGE = PULSE == StepPulse::DUAL_EDGE;
+
     static void init()
     {
         T_PIN_STEP::init();
         T_PIN_DIR::init();
+        stepLevel = false;
     }
 
     static inline void __attribute__((always_inline)) setInverted(bool value);
 
     static inline __attribute__((always_inline)) void step();
 
+    /**
+     * @brief End the pulse of the previous `step()`. Does nothing for `StepPulse::IMMEDIATE`.
+     */
+    static inline __attribute__((always_inline)) void release();
+
     static inline __attribute__((always_inline)) void dir(bool cw);
 };
 
 #ifndef DRIVER_CUSTOM_IMPL
 
-template <typename T_PIN_STEP, typename T_PIN_DIR>
-bool Driver<T_PIN_STEP, T_PIN_DIR>::isInverted = false;
+template <typename T_PIN_STEP, typename T_PIN_DIR, StepPulse PULSE>
+bool Driver<T_PIN_STEP, T_PIN_DIR, PULSE>::isInverted = false;
+
+template <typename T_PIN_STEP, typename T_PIN_DIR, StepPulse PULSE>
+bool Driver<T_PIN_STEP, T_PIN_DIR, PULSE>::stepLevel = false;
 
-template <typename T_PIN_STEP, typename T_PIN_DIR>
-inline __attribute__((always_inline)) void Driver<T_PIN_STEP, T_PIN_DIR>::setInverted(bool value)
+template <typename T_PIN_STEP, typename T_PIN_DIR, StepPulse PULSE>
+inline __attribute__((always_inline)) void Driver<T_PIN_STEP, T_PIN_DIR, PULSE>::setInverted(bool value)
 {
     isInverted = value;
 }
 
-template <typename T_PIN_STEP, typename T_PIN_DIR>
-inline __attribute__((always_inline)) void Driver<T_PIN_STEP, T_PIN_DIR>::step()
+template <typename T_PIN_STEP, typename T_PIN_DIR, StepPulse PULSE>
+inline __attribute__((always_inline)) void Driver<T_PIN_STEP, T_PIN_DIR, PULSE>::step()
 {
-    T_PIN_STEP::pulse();
+    if constexpr (PULSE == StepPulse::DEFERRED)
+    {
+        T_PIN_STEP::high();
+    }
+    else if constexpr (PULSE == StepPulse::DUAL_EDGE)
+    {
+        // the level stays valid whenever the stepper stops, the next step simply flips it back
+        stepLevel = !stepLevel;
+        if (stepLevel)
+        {
+            T_PIN_STEP::high();
+        }
+        else
+        {
+            T_PIN_STEP::low();
+        }
+    }
+    else
+    {
+        T_PIN_STEP::pulse();
+    }
+}
+
+template <typename T_PIN_STEP, typename T_PIN_DIR, StepPulse PULSE>
+inline __attribute__((always_inline)) void Driver<T_PIN_STEP, T_PIN_DIR, PULSE>::release()
+{
+    if constexpr (PULSE == StepPulse::DEFERRED)
+    {
+        T_PIN_STEP::low();
+    }
 }
 
-template <typename T_PIN_STEP, typename T_PIN_DIR>
-inline __attribute__((always_inline)) void Driver<T_PIN_STEP, T_PIN_DIR>::dir(bool cw)
+template <typename T_PIN_STEP, typename T_PIN_DIR, StepPulse PULSE>
+inline __attribute__((always_inline)) void Driver<T_PIN_STEP, T_PIN_DIR, PULSE>::dir(bool cw)
 {
     if (cw != isInverted)
     {
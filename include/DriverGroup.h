@@ -0,0 +1,98 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "Driver.h"
+#include "PinGroup.h"
+
+/**
+ * @brief Several drivers that one `Stepper` moves in lockstep, e.g. the two motors of a gantry axis.
+ *
+ *     using left = Driver<Pin<46>, Pin<47>>;
+ *     using right = Driver<Pin<48>, Pin<49>>;
+ *     using stepper = Stepper<IntervalInterrupt<Timer::TIMER_3>, DriverGroup<left, right>, ramp>;
+ *     ...
+ *     right::setInverted(true); // mirrored motor
+ *
+ * The step pins form a `PinGroup`, so on AVR all drivers step with one port write per port. The
+ * direction is set on every driver on its own and honours its `setInverted()`.
+ *
+ * @tparam FIRST First driver, its `StepPulse` mode applies to the whole group.
+ * @tparam OTHERS Further drivers with the same `StepPulse` mode.
+ */
+template <typename FIRST, typename... OTHERS>
+class DriverGroup
+{
+    static_assert(((OTHERS::PULSE_MODE == FIRST::PULSE_MODE) && ...), "All drivers of a group need the same step pulse mode");
+
+    using StepPins = PinGroup<typename FIRST::StepPin, typename OTHERS::StepPin...>;
+
+    static bool stepLevel; ///< Level of the step pins, only tracked for `StepPulse::DUAL_EDGE`.
+
+public:
+    DriverGroup() = delete;
+
+    constexpr static StepPulse PULSE_MODE = FIRST::PULSE_MODE;
+
+    constexpr static bool DEFERRED_PULSE = FIRST::DEFERRED_PULSE;
+
+    constexpr static bool DUAL_EDGE = FIRST::DUAL_EDGE;
+
+    static void init()
+    {
+        FIRST::init();
+        (OTHERS::init(), ...);
+        stepLevel = false;
+    }
+
+    /**
+     * @brief Invert the direction of every driver of the group. Invert a single driver through its
+     * own `setInverted()`.
+     */
+    static inline __attribute__((always_inline)) void setInverted(bool value)
+    {
+        FIRST::setInverted(value);
+        (OTHERS::setInverted(value), ...);
+    }
+
+    static inline __attribute__((always_inline)) void step()
+    {
+        if constexpr (PULSE_MODE == StepPulse::DEFERRED)
+        {
+            StepPins::high();
+        }
+        else if constexpr (PULSE_MODE == StepPulse::DUAL_EDGE)
+        {
+            stepLevel = !stepLevel;
+            if (stepLevel)
+            {
+                StepPins::high();
+            }
+            else
+            {
+                StepPins::low();
+            }
+        }
+        else
+        {
+            StepPins::pulse();
+        }
+    }
+
+    static inline __attribute__((always_inline)) void release()
+    {
+        if constexpr (PULSE_MODE == StepPulse::DEFERRED)
+        {
+            StepPins::low();
+        }
+    }
+
+    static inline __attribute__((always_inline)) void dir(bool cw)
+    {
+        FIRST::dir(cw);
+        (OTHERS::dir(cw), ...);
+    }
+};
+
+template <typename FIRST, typename... OTHERS>
+bool DriverGroup<FIRST, OTHERS...>::stepLevel = false;
@@ -0,0 +1,286 @@
+#ifndef DYNAMIC_RAMP_H
+#define DYNAMIC_RAMP_H
+
+#include <stdint.h> // NOLINT(modernize-deprecated-headers)
+#include <math.h> // NOLINT(modernize-deprecated-headers)
+#include "AccelerationRamp.h"
+#include "InterruptLock.h"
+
+/// @brief Constant-acceleration ramp whose limits can be changed at runtime.
+///
+/// The interval table lives in RAM instead of flash. A second table is rebuilt in the background,
+/// a bounded number of stairs per `rebuild()` call, while the stepper keeps reading the active one.
+/// `swap()` then activates the finished table by exchanging a single pointer, so `interval()` stays
+/// a plain O(1) array lookup for the interrupt handlers. A move is planned against one table from
+/// start to end, so the swap is refused while any stepper on this ramp is moving.
+///
+/// Unlike `AccelerationRamp`, the distance covered by one stair is fixed by `STEPS` instead of being
+/// derived from the limits. Higher speeds or lower accelerations therefore use more stairs of the
+/// table, and speeds that would need more than `STAIRS - 1` stairs are capped at the top stair.
+///
+/// Both tables cost `2 * STAIRS * 4` bytes of RAM. The storage is static, so every stepper that
+/// needs its own limits has to use a distinct `ID`.
+///
+/// @tparam STAIRS amount of speed stairs to be used during acceleration and/or deceleration
+/// @tparam T_FREQ frequency of the used timer in Hz
+/// @tparam STEPS stepper steps per stair, has to be a power of 2
+/// @tparam ID distinguishes otherwise identical ramps that need separate tables
+///
+template<uint16_t STAIRS, uint32_t T_FREQ, uint8_t STEPS = 64, uint8_t ID = 0>
+class DynamicRamp {
+    template<typename T>
+    constexpr static inline __attribute__((always_inline)) bool is_pow2(const T value) {
+        return (value & (value - 1)) == 0;
+    }
+
+    static_assert(STAIRS > 1, "Amount of stairs has to be at least 2");
+    static_assert(STAIRS <= UINT16_MAX / 2, "Amount of stairs has to be at most 2^15");
+    static_assert(is_pow2(STAIRS), "Amount of stairs has to be power of 2");
+
+    static_assert(T_FREQ > 0, "Timer frequency has to be greater than zero");
+
+    static_assert(STEPS > 0, "Amount of steps per stair has to be greater than zero");
+    static_assert(STEPS <= 128, "Amount of steps per stair has to be at most 128");
+    static_assert(is_pow2(STEPS), "Amount of steps per stair has to be power of 2");
+
+    constexpr static inline float absf(const float value) {
+        return (value < 0.0f) ? -value : value;
+    }
+
+    /// @brief Limits a table was or is being built for.
+    struct Limits {
+        float max_speed;
+        float acceleration;
+        uint32_t min_interval; ///< Interval of `max_speed`, no stair is faster.
+        uint16_t top_stair; ///< Highest stair below or at `max_speed`.
+    };
+
+    static Intervals<STAIRS> tables[2];
+
+    static const Intervals<STAIRS> *volatile active; ///< Table read by `interval()`.
+    static Intervals<STAIRS> *pending; ///< Table being rebuilt.
+
+    static Limits active_limits;
+    static Limits pending_limits;
+
+    static volatile uint8_t moving; ///< Steppers on this ramp that are not idle.
+
+    static uint16_t pending_stair; ///< Next stair of `pending` to compute. `STAIRS` once complete.
+    static float pending_root; ///< `sqrt(pending_stair)`, carried over between rebuild steps.
+    static float pending_c0; ///< Interval scale factor of the pending table.
+
+    static Limits limitsFor(const float max_speed, const float acceleration) {
+        const float speed = absf(max_speed);
+        const float accel = absf(acceleration);
+
+        const float stairs = speed * speed / (2.0f * accel * STEPS);
+
+        Limits limits = {};
+        limits.max_speed = speed;
+        limits.acceleration = accel;
+        limits.min_interval = static_cast<uint32_t>(T_FREQ / speed);
+        limits.top_stair = (stairs >= STAIRS - 1) ? STAIRS - 1 : static_cast<uint16_t>(stairs);
+        return limits;
+    }
+
+public:
+    DynamicRamp() = delete;
+
+    constexpr static uint16_t STAIRS_COUNT = STAIRS;
+
+    constexpr static uint8_t STEPS_PER_STAIR = STEPS;
+
+    constexpr static uint32_t STEPS_TOTAL = static_cast<uint32_t>(STAIRS_COUNT - 1) * STEPS_PER_STAIR;
+
+    /// @brief Build and activate a table synchronously, e.g. during `setup()`.
+    ///
+    /// The ramp has no usable table before the first call, so this has to happen before the first
+    /// move.
+    static void init(const float max_speed, const float acceleration) {
+        configure(max_speed, acceleration);
+        while (!rebuild(STAIRS)) {
+        }
+        swap();
+    }
+
+    /// @brief Start rebuilding the inactive table for new limits.
+    ///
+    /// A rebuild that is still in progress is discarded. The active table is not touched.
+    static void configure(const float max_speed, const float acceleration) {
+        pending_limits = limitsFor(max_speed, acceleration);
+        // Stair n starts after sqrt(2 * n * STEPS / a) seconds, its interval is the stair time
+        // divided by the steps it contains.
+        pending_c0 = T_FREQ * sqrtf(2.0f / (pending_limits.acceleration * STEPS));
+
+        (*pending)[0] = UINT32_MAX;
+        pending_stair = 1;
+        pending_root = 1.0f;
+    }
+
+    /// @brief Compute up to `stairs` more entries of the inactive table.
+    ///
+    /// Every stair costs one square root and one division, so the caller bounds the time spent per
+    /// main-loop iteration through `stairs`.
+    ///
+    /// @return `true` once the table is complete and can be activated by `swap()`.
+    static bool rebuild(const uint16_t stairs) {
+        // nothing configured since the last swap
+        if (pending_stair == 0) {
+            return false;
+        }
+
+        for (uint16_t i = 0; i < stairs && pending_stair < STAIRS; ++i) {
+            // sqrt(n + 1) - sqrt(n) rewritten to avoid cancellation on high stairs
+            const float next_root = sqrtf(static_cast<float>(pending_stair + 1));
+            auto value = static_cast<uint32_t>(pending_c0 / (next_root + pending_root));
+            if (value < pending_limits.min_interval) {
+                value = pending_limits.min_interval;
+            }
+
+            (*pending)[pending_stair++] = value;
+            pending_root = next_root;
+        }
+
+        return pending_stair >= STAIRS;
+    }
+
+    /// @brief Return whether the inactive table is complete.
+    static bool ready() {
+        return pending_stair >= STAIRS;
+    }
+
+    /// @brief Activate the rebuilt table once every stepper on this ramp is idle.
+    ///
+    /// A running move keeps the run interval and stair counts it was planned with from the active
+    /// table, and its deceleration would jump to the speeds of another table. The swap is therefore
+    /// refused while a move runs, and the caller retries after it has ended, e.g. from the main
+    /// loop. Steppers report their moves through `moveStarted()` and `moveEnded()`.
+    ///
+    /// @return `false` if the inactive table is not complete yet or a stepper on this ramp is
+    /// moving.
+    static bool swap() {
+        if (!ready()) {
+            return false;
+        }
+
+        auto *const previous = const_cast<Intervals<STAIRS> *>(active);
+
+        // a move that starts from a callback has to find either the old or the new table
+        const internal::InterruptLock::State irq = internal::InterruptLock::lock();
+        if (moving > 0) {
+            internal::InterruptLock::unlock(irq);
+            return false;
+        }
+        active = pending;
+        internal::InterruptLock::unlock(irq);
+
+        pending = previous;
+        active_limits = pending_limits;
+
+        // The old table becomes the inactive one and has to be rebuilt before the next swap.
+        pending_stair = 0;
+
+        return true;
+    }
+
+    /// @brief Called by `Stepper` when it leaves standstill, with interrupts disabled.
+    static inline void moveStarted() {
+        moving = moving + 1;
+    }
+
+    /// @brief Called by `Stepper` when it comes to a standstill, with interrupts disabled.
+    static inline void moveEnded() {
+        moving = moving - 1;
+    }
+
+    /// @brief Configured maximum speed of the active table in steps/s.
+    static float maxSpeed() {
+        return active_limits.max_speed;
+    }
+
+    /// @brief Configured acceleration of the active table in steps/s/s.
+    static float acceleration() {
+        return active_limits.acceleration;
+    }
+
+    static inline __attribute__((always_inline)) uint32_t interval(const uint16_t stair) {
+        return (*active)[stair];
+    }
+
+    /// @brief Interval for the requested speed, limited to the configured maximum speed.
+    static inline uint32_t getIntervalForSpeed(const float sps) {
+        const auto value = static_cast<uint32_t>(T_FREQ / absf(sps));
+        return (value < active_limits.min_interval) ? active_limits.min_interval : value;
+    }
+
+    /// @brief Integer counterpart of `getIntervalForSpeed()`, limited to the configured maximum speed.
+    static inline uint32_t getIntervalForSpeed(const FixedSpeed speed) {
+        const uint32_t value = speed.interval<T_FREQ>();
+        return (value < active_limits.min_interval) ? active_limits.min_interval : value;
+    }
+
+    /// @brief Fraction of a tick truncated by `getIntervalForSpeed()`, in 1/65536 ticks.
+    ///
+    /// Speeds clamped to the configured maximum have no fraction.
+    static inline uint16_t getIntervalFractionForSpeed(const float sps) {
+        const float exact = T_FREQ / absf(sps);
+        if (exact < static_cast<float>(active_limits.min_interval)) {
+            return 0;
+        }
+        return static_cast<uint16_t>((exact - static_cast<float>(static_cast<uint32_t>(exact))) * 65536.0f);
+    }
+
+    static inline uint16_t getIntervalFractionForSpeed(const FixedSpeed speed) {
+        return (speed.interval<T_FREQ>() < active_limits.min_interval) ? 0 : speed.intervalFraction<T_FREQ>();
+    }
+
+    /// @brief Highest stair of the active profile that is not faster than `interval`.
+    static inline uint16_t maxAccelStairsForInterval(const uint32_t interval) {
+        if (interval <= active_limits.min_interval) {
+            return active_limits.top_stair;
+        }
+
+        const uint16_t stair = active->stairFor(interval);
+        return (stair >= active_limits.top_stair) ? active_limits.top_stair : stair;
+    }
+
+    static inline uint16_t maxAccelStairs(const float sps) {
+        const float speed = absf(sps);
+
+        if (speed >= active_limits.max_speed) {
+            return active_limits.top_stair;
+        }
+
+        const auto stairs = static_cast<uint16_t>(speed * speed / (2.0f * active_limits.acceleration * STEPS));
+        return (stairs >= active_limits.top_stair) ? active_limits.top_stair : stairs;
+    }
+};
+
+template<uint16_t STAIRS, uint32_t T_FREQ, uint8_t STEPS, uint8_t ID>
+Intervals<STAIRS> DynamicRamp<STAIRS, T_FREQ, STEPS, ID>::tables[2] = {};
+
+template<uint16_t STAIRS, uint32_t T_FREQ, uint8_t STEPS, uint8_t ID>
+const Intervals<STAIRS> *volatile DynamicRamp<STAIRS, T_FREQ, STEPS, ID>::active = &DynamicRamp<STAIRS, T_FREQ, STEPS, ID>::tables[0];
+
+template<uint16_t STAIRS, uint32_t T_FREQ, uint8_t STEPS, uint8_t ID>
+Intervals<STAIRS> *DynamicRamp<STAIRS, T_FREQ, STEPS, ID>::pending = &DynamicRamp<STAIRS, T_FREQ, STEPS, ID>::tables[1];
+
+template<uint16_t STAIRS, uint32_t T_FREQ, uint8_t STEPS, uint8_t ID>
+typename DynamicRamp<STAIRS, T_FREQ, STEPS, ID>::Limits DynamicRamp<STAIRS, T_FREQ, STEPS, ID>::active_limits = {};
+
+template<uint16_t STAIRS, uint32_t T_FREQ, uint8_t STEPS, uint8_t ID>
+typename DynamicRamp<STAIRS, T_FREQ, STEPS, ID>::Limits DynamicRamp<STAIRS, T_FREQ, STEPS, ID>::pending_limits = {};
+
+template<uint16_t STAIRS, uint32_t T_FREQ, uint8_t STEPS, uint8_t ID>
+volatile uint8_t DynamicRamp<STAIRS, T_FREQ, STEPS, ID>::moving = 0;
+
+template<uint16_t STAIRS, uint32_t T_FREQ, uint8_t STEPS, uint8_t ID>
+uint16_t DynamicRamp<STAIRS, T_FREQ, STEPS, ID>::pending_stair = 0;
+
+template<uint16_t STAIRS, uint32_t T_FREQ, uint8_t STEPS, uint8_t ID>
+float DynamicRamp<STAIRS, T_FREQ, STEPS, ID>::pending_root = 0.0f;
+
+template<uint16_t STAIRS, uint32_t T_FREQ, uint8_t STEPS, uint8_t ID>
+float DynamicRamp<STAIRS, T_FREQ, STEPS, ID>::pending_c0 = 0.0f;
+
+#endif // DYNAMIC_RAMP_H
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <stdint.h> // NOLINT(modernize-deprecated-headers)
+
+/**
+ * @brief Signed speed in millisteps per second.
+ *
+ * This is the integer counterpart of the `float` speeds accepted by the ramps and by `Stepper`. All
+ * conversions needed to plan a move are done with 32-bit integer math, so no software float
+ * routine is involved on targets without an FPU. That is not cheaper: on AVR the 32/32 bit
+ * division of `interval()` takes about as long as a soft-float division. It keeps the float
+ * library out of sketches that need no other float math, and the intervals exact. The range of
+ * ±2147483 steps/s with a resolution of 0.001 steps/s covers every practical stepper speed, which
+ * a Q16.16 value (at most 32767 steps/s) would not.
+ *
+ * The type has no implicit conversions, so an integer literal can never be mistaken for a speed.
+ */
+class FixedSpeed
+{
+private:
+    int32_t _milli;
+
+    constexpr explicit FixedSpeed(const int32_t milli) : _milli(milli)
+    {
+        // Nothing to do here
+    }
+
+    /// @brief Quotient and remainder of `T_FREQ * 1000 / milli`, see `interval()`.
+    struct Division
+    {
+        uint32_t quotient;
+        uint32_t remainder;
+        uint32_t divisor;
+    };
+
+    template <uint32_t T_FREQ>
+    [[nodiscard]] constexpr Division divide() const
+    {
+        const uint32_t abs_milli = absMilli();
+
+        if (abs_milli == 0)
+        {
+            return {UINT32_MAX, 0, 1};
+        }
+
+        const uint32_t whole = T_FREQ / abs_milli;
+        if (whole > (UINT32_MAX - 999U) / 1000U)
+        {
+            return {UINT32_MAX, 0, 1};
+        }
+
+        // (T_FREQ % milli) * 1000 / milli, multiplied bit by bit of 1000 and reduced after every
+        // step. Both operands stay below the divisor, so no intermediate value exceeds 32 bits.
+        const uint32_t rest = T_FREQ % abs_milli;
+        uint32_t quotient = 0;
+        uint32_t remainder = 0;
+        for (uint16_t bit = 512; bit > 0; bit >>= 1)
+        {
+            quotient <<= 1;
+            remainder <<= 1;
+            if (remainder >= abs_milli)
+            {
+                remainder -= abs_milli;
+                quotient++;
+            }
+
+            if ((1000U & bit) != 0)
+            {
+                remainder += rest;
+                if (remainder >= abs_milli)
+                {
+                    remainder -= abs_milli;
+                    quotient++;
+                }
+            }
+        }
+
+        return {(whole * 1000U) + quotient, remainder, abs_milli};
+    }
+
+public:
+    constexpr FixedSpeed() : _milli(0)
+    {
+        // Nothing to do here
+    }
+
+    /**
+     * @brief Create a speed from millisteps per second.
+     */
+    constexpr static FixedSpeed milli(const int32_t millistepsPerSecond)
+    {
+        return FixedSpeed(millistepsPerSecond);
+    }
+
+    /**
+     * @brief Create a speed from whole steps per second.
+     */
+    constexpr static FixedSpeed sps(const int32_t stepsPerSecond)
+    {
+        return FixedSpeed(stepsPerSecond * 1000);
+    }
+
+    constexpr FixedSpeed operator-() const
+    {
+        return FixedSpeed(-_milli);
+    }
+
+    [[nodiscard]] constexpr int32_t milli() const
+    {
+        return _milli;
+    }
+
+    [[nodiscard]] constexpr bool isNegative() const
+    {
+        return _milli < 0;
+    }
+
+    /**
+     * @brief Magnitude in millisteps per second.
+     */
+    [[nodiscard]] constexpr uint32_t absMilli() const
+    {
+        return (_milli < 0) ? 0U - static_cast<uint32_t>(_milli) : static_cast<uint32_t>(_milli);
+    }
+
+    /**
+     * @brief Timer interval between two steps at this speed.
+     *
+     * `T_FREQ * 1000 / milli` does not fit into 32 bits for common timer frequencies, so whole
+     * ticks and the remainder are divided separately. The remainder is scaled by 1000 with ten
+     * shift-and-add rounds, which keeps the result exact without any 64-bit arithmetic.
+     *
+     * @return `UINT32_MAX` for speeds too slow to be represented.
+     */
+    template <uint32_t T_FREQ>
+    [[nodiscard]] constexpr uint32_t interval() const
+    {
+        return divide<T_FREQ>().quotient;
+    }
+
+    /**
+     * @brief Fractional tick truncated by `interval()`, in 1/65536 ticks.
+     *
+     * The remainder of the interval division is carried on by binary long division, so this
+     * costs 16 shift-and-subtract rounds but no wider arithmetic.
+     *
+     * @return `0` for speeds too slow to be represented.
+     */
+    template <uint32_t T_FREQ>
+    [[nodiscard]] constexpr uint16_t intervalFraction() const
+    {
+        const Division division = divide<T_FREQ>();
+
+        uint32_t remainder = division.remainder;
+        uint16_t fraction = 0;
+        for (uint8_t i = 0; i < 16; i++)
+        {
+            // remainder < divisor <= 2^31, so the shift can not overflow
+            remainder <<= 1;
+            fraction = static_cast<uint16_t>(fraction << 1);
+            if (remainder >= division.divisor)
+            {
+                remainder -= division.divisor;
+                fraction |= 1U;
+            }
+        }
+        return fraction;
+    }
+
+    /**
+     * @brief Steps covered within `time_ms` milliseconds, truncated toward zero.
+     *
+     * Whole and fractional steps per second are multiplied separately, which keeps every product
+     * in 32 bits for durations below 24 days while still rounding exactly like
+     * `milli * time_ms / 1000000`.
+     */
+    [[nodiscard]] constexpr int32_t stepsIn(const uint32_t time_ms) const
+    {
+        const uint32_t abs_milli = absMilli();
+        const uint32_t whole = abs_milli / 1000U;
+        const uint32_t fraction = abs_milli % 1000U;
+
+        const uint32_t seconds = time_ms / 1000U;
+        const uint32_t rest_ms = time_ms % 1000U;
+
+        // (whole * 1000 + fraction) * (seconds * 1000 + rest_ms) / 1000000, expanded
+        const uint32_t milli_steps = (whole * rest_ms) + (fraction * seconds) + ((fraction * rest_ms) / 1000U);
+        const uint32_t steps = (whole * seconds) + (milli_steps / 1000U);
+
+        return (_milli < 0) ? -static_cast<int32_t>(steps) : static_cast<int32_t>(steps);
+    }
+};
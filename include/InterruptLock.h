@@ -0,0 +1,86 @@
+#pragma once
+
+#include <stdint.h> // NOLINT(modernize-deprecated-headers)
+
+#if defined(ARDUINO_ARCH_AVR)
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#elif defined(ARDUINO) && !(defined(__ARM_ARCH_PROFILE) && (__ARM_ARCH_PROFILE == 'M'))
+#include <Arduino.h>
+#endif
+
+namespace internal
+{
+    /**
+     * @brief Critical section that restores the interrupt state it found.
+     *
+     * `lock()` disables interrupts and returns whether they were enabled before, `unlock()` puts
+     * that state back. A section entered from an interrupt handler or from a stepper callback
+     * therefore leaves interrupts disabled, while `noInterrupts()` and `interrupts()` would enable
+     * them in the middle of the handler. AVR saves SREG, Cortex-M saves PRIMASK. Other Arduino
+     * cores fall back to `noInterrupts()` and `interrupts()`. Host builds only track the state in
+     * `enabled`, so tests can check that a section left it alone.
+     */
+    struct InterruptLock
+    {
+#if defined(ARDUINO_ARCH_AVR)
+        using State = uint8_t;
+
+        static inline __attribute__((always_inline)) State lock()
+        {
+            const State sreg = SREG;
+            cli();
+            return sreg;
+        }
+
+        static inline __attribute__((always_inline)) void unlock(const State sreg)
+        {
+            SREG = sreg;
+        }
+#elif defined(ARDUINO) && defined(__ARM_ARCH_PROFILE) && (__ARM_ARCH_PROFILE == 'M')
+        using State = uint32_t;
+
+        static inline __attribute__((always_inline)) State lock()
+        {
+            State primask;
+            __asm__ volatile("mrs %0, primask" : "=r"(primask));
+            __asm__ volatile("cpsid i" ::: "memory");
+            return primask;
+        }
+
+        static inline __attribute__((always_inline)) void unlock(const State primask)
+        {
+            __asm__ volatile("msr primask, %0" ::"r"(primask) : "memory");
+        }
+#elif defined(ARDUINO)
+        using State = uint8_t;
+
+        static inline __attribute__((always_inline)) State lock()
+        {
+            noInterrupts();
+            return 0;
+        }
+
+        static inline __attribute__((always_inline)) void unlock(const State)
+        {
+            interrupts();
+        }
+#else
+        using State = bool;
+
+        static inline bool enabled = true;
+
+        static inline State lock()
+        {
+            const State state = enabled;
+            enabled = false;
+            return state;
+        }
+
+        static inline void unlock(const State state)
+        {
+            enabled = state;
+        }
+#endif
+    };
+}
@@ -24,6 +24,18 @@ public:
     static void setInterval(uint32_t value);
 
     static void stop();
+
+#if defined(CUSTOM_TIMER_INTERRUPT_IMPL) || defined(ARDUINO_ARCH_AVR) || defined(ARDUINO_ARCH_STM32)
+    /// Ticks since the last interrupt. Only needed by ramps that emit several steps per interrupt.
+    /// The Delegate backend has no counter to read and leaves it undeclared.
+    static uint32_t elapsed();
+#endif
+
+    /// Keep timers started from now on halted until `release()`, see `SyncStart`.
+    static void hold();
+
+    /// Let the timers started since `hold()` count.
+    static void release();
 };
 
 #ifndef CUSTOM_TIMER_INTERRUPT_IMPL
@@ -3,6 +3,7 @@
 #if defined(ARDUINO_ARCH_AVR)
 
 #include <IntervalInterrupt.h>
+#include <TimerPrescaler.h>
 #include <stdint.h>
 #include <avr/interrupt.h>
 
@@ -47,8 +48,29 @@ struct IntervalInterrupt_AVR
     static volatile uint8_t ovf_cnt;
     static volatile uint8_t ovf_left;
 
+    /// log2 of the prescaler the timer currently runs on.
+    static uint8_t shift;
+    /// CPU cycles below one prescaled tick, carried into the next interval.
+    static uint16_t residue;
+    /// Last value of `setInterval()`.
+    static uint32_t interval;
+    /// Whether the compare value of `interval` took a different residue than it left, see `handle_compare_match()`.
+    static bool carries;
+    /// Whether `setInterval()` was called since the last compare match.
+    static bool programmed;
+    /// Residue left by the interval that ended with the last compare match, i.e. how early it came.
+    static uint16_t lead;
+
     static volatile timer_callback callback;
 
+    /// COMnA bits of `CompareOutputPin`, disconnected while the timer counts overflows. Zero without one.
+    static volatile uint8_t com_bits;
+
+    /// Whether a move started now waits for `release()`, see `hold()`.
+    static bool held;
+    /// Clock select bits of a move started while held, zero if there is none.
+    static uint8_t held_cs;
+
     constexpr static inline __attribute__((always_inline)) volatile uint8_t *TCCRA()
     {
         switch (T)
@@ -83,6 +105,43 @@ struct IntervalInterrupt_AVR
         }
     }
 
+    constexpr static inline __attribute__((always_inline)) volatile uint8_t *TCCRC()
+    {
+        switch (T)
+        {
+        case Timer::TIMER_1:
+            return &TCCR1C;
+        case Timer::TIMER_3:
+            return &TCCR3C;
+        case Timer::TIMER_4:
+            return &TCCR4C;
+        case Timer::TIMER_5:
+            return &TCCR5C;
+        default:
+            return 0;
+        }
+    }
+
+    /**
+     * @brief Arduino pin number of OCnA on the ATmega2560.
+     */
+    constexpr static inline __attribute__((always_inline)) uint8_t OCA_PIN()
+    {
+        switch (T)
+        {
+        case Timer::TIMER_1:
+            return 11; // PB5
+        case Timer::TIMER_3:
+            return 5; // PE3
+        case Timer::TIMER_4:
+            return 6; // PH3
+        case Timer::TIMER_5:
+            return 46; // PL3
+        default:
+            return 0;
+        }
+    }
+
     constexpr static inline __attribute__((always_inline)) volatile uint16_t *OCRA()
     {
         switch (T)
@@ -184,18 +243,37 @@ struct IntervalInterrupt_AVR
         sei();              // reenable interrupts
     }
 
+    /**
+     * @brief Make OCnA an output, see `CompareOutputPin`. Its port bit stays low, which is the level
+     * of the pin while the compare output is disconnected.
+     */
+    static inline __attribute__((always_inline)) void initCompareOutput()
+    {
+        digitalWrite(OCA_PIN(), LOW);
+        pinMode(OCA_PIN(), OUTPUT);
+    }
+
+    /**
+     * @brief Program the next interval, on the smallest prescaler that holds it, see `internal::TimerPrescaler`.
+     *
+     * Called from the compare match ISR the counter has already advanced by the interrupt latency.
+     * On a prescaler change that count is converted to the new prescaler, so the interval is off by
+     * less than one prescaled tick. The timers share one prescaler, whose phase is not reset either.
+     */
     static inline __attribute__((always_inline)) void setInterval(uint32_t value)
     {
         SET_INTERVAL_TIMING_START();
 
-        value = value - 1;
+        interval = value;
+        programmed = true;
 
-        // lower 16 bit of value will be used for compare match. thus we are only interested
-        // in higher 16 bit for amount of overflows
-        ovf_cnt = static_cast<uint8_t>(value >> 16);
+        const uint16_t carried = residue;
+        const internal::PrescaledInterval next = internal::TimerPrescaler::split(value - 1, residue);
+        carries = residue != carried;
 
-        // set compare match to the value of lower 16 bits
-        *OCRA() = static_cast<uint16_t>((value & 0xFFFF) - 1);
+        // the overflows count full 16 bit periods, the last stretch ends with the compare match
+        ovf_cnt = next.ovf;
+        *OCRA() = next.ocr;
 
         if (ovf_cnt == 0)
         {
@@ -209,8 +287,21 @@ struct IntervalInterrupt_AVR
             ovf_left = ovf_cnt;
         }
 
-        // set prescaler to 1 (count at MCU frequency)
-        *TCCRB() |= 1;
+        if (next.shift != shift)
+        {
+            *TCNT() = static_cast<uint16_t>((static_cast<uint32_t>(*TCNT()) << shift) >> next.shift);
+            shift = next.shift;
+        }
+
+        // start the timer on the selected prescaler, a stopped one only once released
+        if (held && (*TCCRB() & 0b111) == 0)
+        {
+            held_cs = next.cs;
+        }
+        else
+        {
+            *TCCRB() = (*TCCRB() & ~0b111) | next.cs;
+        }
 
         SET_INTERVAL_TIMING_END();
     }
@@ -222,6 +313,44 @@ struct IntervalInterrupt_AVR
 
         // set counter to 0
         *TCNT() = 0;
+
+        // the next move starts on whole ticks
+        residue = 0;
+        lead = 0;
+
+        // a move stopped while held is not started by the release
+        held_cs = 0;
+
+        // stopped while counting overflows, the first match of the next move is a step
+        *TCCRA() |= com_bits;
+    }
+
+    /**
+     * @brief Do not let a move that starts from now on run before `release()`, see `SyncStart`.
+     *
+     * The timer of such a move is left with its clock select bits cleared, so it does not count
+     * on any prescaler. Moves that are already running are not affected.
+     */
+    static inline __attribute__((always_inline)) void hold()
+    {
+        held = true;
+    }
+
+    /**
+     * @brief Start the timer of a move that was started while held.
+     *
+     * Called by `SyncStart` for each timer in turn with interrupts disabled, so the timers start a
+     * few cycles apart. Prescaled timers take their first tick on the next edge of the shared
+     * prescaler, which is the same edge for all of them unless one falls between two writes.
+     */
+    static inline __attribute__((always_inline)) void release()
+    {
+        held = false;
+        if (held_cs != 0)
+        {
+            *TCCRB() |= held_cs;
+            held_cs = 0;
+        }
     }
 
     static inline __attribute__((always_inline)) void handle_overflow()
@@ -231,23 +360,32 @@ struct IntervalInterrupt_AVR
         // check if this was the last overflow and we need to count the rest
         if (--ovf_left == 0)
         {
-            // Timer/Counter1 Output Compare A Match Interrupt Enable
-            *TIMSK() |= (1 << 1);
-
-            // enable CTC mode (clear timer on compare)
-            *TCCRB() |= (1 << 3);
-
-            // clear Output Compare Flag 1A because it was set during overflow mode.
-            // Not doing so will lead to interrupt executing instantly after this
-            *TIFR() |= (1 << 1);
+            count_rest();
         }
         INTERRUPT_TIMING_END();
     }
 
-    static inline __attribute__((always_inline)) void handle_compare_match()
+    /**
+     * @brief Last overflow of a long interval: count the rest up to the compare match.
+     */
+    static inline __attribute__((always_inline)) void count_rest()
     {
-        INTERRUPT_TIMING_START();
+        // Timer/Counter1 Output Compare A Match Interrupt Enable
+        *TIMSK() |= (1 << 1);
+
+        // enable CTC mode (clear timer on compare)
+        *TCCRB() |= (1 << 3);
+
+        // clear Output Compare Flag 1A because it was set during overflow mode.
+        // Not doing so will lead to interrupt executing instantly after this
+        *TIFR() |= (1 << 1);
+
+        // the next compare match is a step again
+        *TCCRA() |= com_bits;
+    }
 
+    static inline __attribute__((always_inline)) void rearm_overflows()
+    {
         // check if we need to switch to overflows again (slow frequency)
         if (ovf_cnt > 0)
         {
@@ -257,13 +395,39 @@ struct IntervalInterrupt_AVR
             // disable CTC mode (clear timer on compare)
             *TCCRB() &= ~(1 << 3);
 
+            // compare matches while counting overflows must not reach the step pin
+            *TCCRA() &= ~com_bits;
+
             // reset overflow countdown
             ovf_left = ovf_cnt;
         }
+    }
+
+    /**
+     * @brief Compare match: run the callback, which usually programs the next interval.
+     *
+     * Without a new interval CTC mode repeats the compare value. If that value was rounded to
+     * whole prescaled ticks, or took the residue of the interval before, the interval is split
+     * again, so the residue is carried on every repeat and the steps do not drift.
+     */
+    static inline __attribute__((always_inline)) void handle_compare_match()
+    {
+        INTERRUPT_TIMING_START();
+
+        rearm_overflows();
+
+        lead = residue;
+        programmed = false;
 
         // execute the callback
         callback();
 
+        // a stopped timer has its clock select bits cleared
+        if (carries && !programmed && (*TCCRB() & 0b111) != 0)
+        {
+            setInterval(interval);
+        }
+
         INTERRUPT_TIMING_END();
     }
 };
@@ -292,15 +456,63 @@ inline __attribute__((always_inline)) void IntervalInterrupt<T>::stop()
     IntervalInterrupt_AVR<T>::stop();
 }
 
+template <Timer T>
+inline __attribute__((always_inline)) uint32_t IntervalInterrupt<T>::elapsed()
+{
+    // CTC mode restarts the counter at the compare match, which came `lead` cycles before it was
+    // due. Right after it the result wraps below zero, the stepper only uses differences.
+    return (static_cast<uint32_t>(*IntervalInterrupt_AVR<T>::TCNT()) << IntervalInterrupt_AVR<T>::shift) -
+           IntervalInterrupt_AVR<T>::lead;
+}
+
+template <Timer T>
+inline __attribute__((always_inline)) void IntervalInterrupt<T>::hold()
+{
+    IntervalInterrupt_AVR<T>::hold();
+}
+
+template <Timer T>
+inline __attribute__((always_inline)) void IntervalInterrupt<T>::release()
+{
+    IntervalInterrupt_AVR<T>::release();
+}
+
 template <Timer T>
 volatile uint8_t IntervalInterrupt_AVR<T>::ovf_cnt = 0;
 
 template <Timer T>
 volatile uint8_t IntervalInterrupt_AVR<T>::ovf_left = 0;
 
+template <Timer T>
+uint8_t IntervalInterrupt_AVR<T>::shift = 0;
+
+template <Timer T>
+uint16_t IntervalInterrupt_AVR<T>::residue = 0;
+
+template <Timer T>
+uint32_t IntervalInterrupt_AVR<T>::interval = 0;
+
+template <Timer T>
+bool IntervalInterrupt_AVR<T>::carries = false;
+
+template <Timer T>
+bool IntervalInterrupt_AVR<T>::programmed = false;
+
+template <Timer T>
+uint16_t IntervalInterrupt_AVR<T>::lead = 0;
+
 template <Timer T>
 volatile timer_callback IntervalInterrupt_AVR<T>::callback = nullptr;
 
+template <Timer T>
+volatile uint8_t IntervalInterrupt_AVR<T>::com_bits = 0;
+
+template <Timer T>
+bool IntervalInterrupt_AVR<T>::held = false;
+
+template <Timer T>
+uint8_t IntervalInterrupt_AVR<T>::held_cs = 0;
+
 template <Timer T>
 const uint32_t IntervalInterrupt<T>::FREQ = F_CPU;
 
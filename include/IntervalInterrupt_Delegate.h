@@ -19,6 +19,8 @@ struct IntervalInterrupt_Delegate
     static etl::delegate<void(uint32_t)> setInterval;
     static etl::delegate<void(timer_callback)> setCallback;
     static etl::delegate<void()> stop;
+    static etl::delegate<void()> hold;
+    static etl::delegate<void()> release;
 };
 
 template <Timer T>
@@ -33,6 +35,12 @@ etl::delegate<void(timer_callback)> IntervalInterrupt_Delegate<T>::setCallback =
 template <Timer T>
 etl::delegate<void()> IntervalInterrupt_Delegate<T>::stop = etl::delegate<void()>();
 
+template <Timer T>
+etl::delegate<void()> IntervalInterrupt_Delegate<T>::hold = etl::delegate<void()>();
+
+template <Timer T>
+etl::delegate<void()> IntervalInterrupt_Delegate<T>::release = etl::delegate<void()>();
+
 template <Timer T>
 const uint32_t IntervalInterrupt<T>::FREQ = F_CPU;
 
@@ -70,4 +78,22 @@ void IntervalInterrupt<T>::stop()
     {
         IntervalInterrupt_Delegate<T>::stop();
     }
-}
\ No newline at end of file
+}
+
+template <Timer T>
+void IntervalInterrupt<T>::hold()
+{
+    if (IntervalInterrupt_Delegate<T>::hold.is_valid())
+    {
+        IntervalInterrupt_Delegate<T>::hold();
+    }
+}
+
+template <Timer T>
+void IntervalInterrupt<T>::release()
+{
+    if (IntervalInterrupt_Delegate<T>::release.is_valid())
+    {
+        IntervalInterrupt_Delegate<T>::release();
+    }
+}
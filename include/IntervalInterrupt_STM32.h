@@ -4,6 +4,7 @@
 
 #include <IntervalInterrupt.h>
 #include <stdint.h>
+#include "DriftFreeTimer.h"
 #include "HardwareTimer.h"
 
 #define DEBUG_INTERRUPT_TIMING_PIN 0
@@ -538,78 +539,69 @@ constexpr TIM_TypeDef *timer_def_from_enum(const Timer timer)
     }
 }
 
+/**
+ * @brief Hardware access to an STM32 timer for `internal::DriftFreeTimer`.
+ */
 template <Timer T>
 struct IntervalInterrupt_STM32
 {
+    using Regs = TIM_TypeDef;
+    using Engine = internal::DriftFreeTimer<IntervalInterrupt_STM32<T>>;
+
+    constexpr static uint32_t FREQ = F_CPU;
+
     static HardwareTimer timer;
 
-    static volatile uint16_t ovf_cnt;
-    static volatile uint16_t ovf_left;
-    static volatile uint16_t cmp_cnt;
+    static inline __attribute__((always_inline)) Regs *regs()
+    {
+        return timer_def_from_enum(T);
+    }
 
-    static volatile timer_callback callback;
+    /**
+     * @brief Whether the counter has 32 bits, so that every interval fits into a single period.
+     */
+    static inline __attribute__((always_inline)) bool wide()
+    {
+#ifdef IS_TIM_32B_COUNTER_INSTANCE
+        return IS_TIM_32B_COUNTER_INSTANCE(regs());
+#else
+        return false;
+#endif
+    }
 
     static inline __attribute__((always_inline)) void init()
     {
+        timer.pause();
         timer.setPreloadEnable(false);
         timer.setPrescaleFactor(1);
+        timer.setOverflow(wide() ? UINT32_MAX : UINT16_MAX, TICK_FORMAT);
+        timer.attachInterrupt(handle_update);
+        timer.refresh();
     }
 
-    static inline __attribute__((always_inline)) void set_interval(uint32_t value)
+    static inline __attribute__((always_inline)) void resume()
     {
-        SET_INTERVAL_TIMING_START();
-
-        ovf_cnt = (value >> 16);
-
-        if (ovf_cnt)
-        {
-            ovf_left = ovf_cnt;
-            timer.setOverflow(UINT16_MAX);
-            timer.attachInterrupt(handle_overflow);
-        }
-        else
-        {
-            ovf_left = 0;
-            timer.setOverflow((value & 0xFFFF) - 1);
-            timer.attachInterrupt(handle_compare_match);
-        }
-
-        timer.refresh();
         timer.resume();
-
-        SET_INTERVAL_TIMING_END();
     }
 
-    static inline __attribute__((always_inline)) void handle_overflow()
+    static inline __attribute__((always_inline)) void pause()
     {
-        INTERRUPT_TIMING_START();
-
-        // decrement amount of left overflows
-        ovf_left--;
+        timer.pause();
+    }
 
-        // check if this was the last overflow and we need to count the rest
-        if (ovf_left == 0)
-        {
-            timer.attachInterrupt(handle_compare_match);
-        }
-        INTERRUPT_TIMING_END();
+    /**
+     * @brief Hand `pin` to the timer, see `CompareOutputPin_STM32`. It has to be TIMx_CH1 of this
+     * timer, and the first timer listed for it in the variant's `PinMap_TIM`.
+     */
+    static inline void initCompareOutput(const uint32_t pin)
+    {
+        pinmap_pinout(digitalPinToPinName(pin), PinMap_TIM);
     }
 
-    static inline __attribute__((always_inline)) void handle_compare_match()
+    static void handle_update()
     {
         INTERRUPT_TIMING_START();
-
-        // check if we need to switch to overflows again (slow frequency)
-        if (ovf_cnt)
-        {
-            // reset overflow countdown
-            ovf_left = ovf_cnt;
-            timer.attachInterrupt(handle_overflow);
-        }
-
-        // execute the callback
-        callback();
-
+        Engine::handle_update();
         INTERRUPT_TIMING_END();
     }
 };
@@ -617,15 +609,6 @@ struct IntervalInterrupt_STM32
 template <Timer T>
 HardwareTimer IntervalInterrupt_STM32<T>::timer = HardwareTimer(timer_def_from_enum(T));
 
-template <Timer T>
-volatile uint16_t IntervalInterrupt_STM32<T>::ovf_cnt = 0;
-
-template <Timer T>
-volatile uint16_t IntervalInterrupt_STM32<T>::ovf_left = 0;
-
-template <Timer T>
-volatile timer_callback IntervalInterrupt_STM32<T>::callback = nullptr;
-
 template <Timer T>
 void IntervalInterrupt<T>::init()
 {
@@ -636,25 +619,45 @@ void IntervalInterrupt<T>::init()
     Pin<DEBUG_INTERRUPT_TIMING_PIN>::init();
 #endif
 
-    IntervalInterrupt_STM32<T>::init();
+    IntervalInterrupt_STM32<T>::Engine::init();
 }
 
 template <Timer T>
 inline __attribute__((always_inline)) void IntervalInterrupt<T>::setInterval(uint32_t value)
 {
-    IntervalInterrupt_STM32<T>::set_interval(value);
+    SET_INTERVAL_TIMING_START();
+    IntervalInterrupt_STM32<T>::Engine::setInterval(value);
+    SET_INTERVAL_TIMING_END();
 }
 
 template <Timer T>
 void inline __attribute__((always_inline)) IntervalInterrupt<T>::setCallback(timer_callback fn)
 {
-    IntervalInterrupt_STM32<T>::callback = fn;
+    IntervalInterrupt_STM32<T>::Engine::setCallback(fn);
 }
 
 template <Timer T>
 inline __attribute__((always_inline)) void IntervalInterrupt<T>::stop()
 {
-    IntervalInterrupt_STM32<T>::timer.pause();
+    IntervalInterrupt_STM32<T>::Engine::stop();
+}
+
+template <Timer T>
+inline __attribute__((always_inline)) uint32_t IntervalInterrupt<T>::elapsed()
+{
+    return IntervalInterrupt_STM32<T>::Engine::elapsed();
+}
+
+template <Timer T>
+inline __attribute__((always_inline)) void IntervalInterrupt<T>::hold()
+{
+    IntervalInterrupt_STM32<T>::Engine::hold();
+}
+
+template <Timer T>
+inline __attribute__((always_inline)) void IntervalInterrupt<T>::release()
+{
+    IntervalInterrupt_STM32<T>::Engine::release();
 }
 
 template <Timer T>
@@ -15,12 +15,26 @@ public:
     static inline __attribute__((always_inline)) void high();
 
     static inline __attribute__((always_inline)) void low();
+
+#if defined(ARDUINO_ARCH_AVR)
+    /// Cycles of one `high()` or `low()`.
+    static constexpr uint8_t writeCycles();
+
+    /// Cycles of one `pulse()`.
+    static constexpr uint8_t pulseCycles();
+#endif
 };
 
 #ifndef PIN_CUSTOM_IMPL
 
 #if defined(ARDUINO_ARCH_AVR)
 #include "Pin_AVR.h"
+#elif defined(ARDUINO_ARCH_STM32)
+#include "Pin_STM32.h"
+#elif defined(ARDUINO_ARCH_SAMD)
+#include "Pin_SAMD.h"
+#elif defined(ARDUINO_ARCH_RP2040) && !defined(ARDUINO_ARCH_MBED)
+#include "Pin_RP2040.h"
 #elif defined(ARDUINO)
 #include "Pin_Arduino.h"
 #else
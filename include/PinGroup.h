@@ -0,0 +1,66 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "Pin.h"
+
+/**
+ * @brief Several output pins that always switch together, usable wherever a single `Pin` is.
+ *
+ * `Driver<PinGroup<Pin<46>, Pin<48>>, PinGroup<Pin<47>, Pin<49>>>` steps both motors of a gantry
+ * axis from one `Stepper`. On AVR the pins are merged per port at compile time, so the group costs
+ * one write per port instead of one per pin, see `internal::PinGroupPorts`. Elsewhere, or if the group holds
+ * pins other than `Pin<N>`, every pin is written on its own.
+ *
+ * `pulse()` raises all pins before lowering any of them, so the pulses overlap.
+ *
+ * @tparam PINS Pins of the group, at least one.
+ */
+template <typename... PINS>
+class PinGroup
+{
+    static_assert(sizeof...(PINS) > 0, "A pin group needs at least one pin");
+
+public:
+    PinGroup() = delete;
+
+    static void init()
+    {
+        (PINS::init(), ...);
+    }
+
+    static inline __attribute__((always_inline)) void pulse();
+
+    static inline __attribute__((always_inline)) void high();
+
+    static inline __attribute__((always_inline)) void low();
+};
+
+#ifndef PIN_CUSTOM_IMPL
+
+#if defined(ARDUINO_ARCH_AVR)
+#include "PinGroup_AVR.h"
+#else
+
+template <typename... PINS>
+inline __attribute__((always_inline)) void PinGroup<PINS...>::pulse()
+{
+    (PINS::high(), ...);
+    (PINS::low(), ...);
+}
+
+template <typename... PINS>
+inline __attribute__((always_inline)) void PinGroup<PINS...>::high()
+{
+    (PINS::high(), ...);
+}
+
+template <typename... PINS>
+inline __attribute__((always_inline)) void PinGroup<PINS...>::low()
+{
+    (PINS::low(), ...);
+}
+
+#endif
+
+#endif // PIN_CUSTOM_IMPL
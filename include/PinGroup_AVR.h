@@ -0,0 +1,180 @@
+#pragma once
+
+#ifdef ARDUINO_ARCH_AVR
+
+#include <Arduino.h>
+
+#include "Pin.h"
+
+namespace internal
+{
+    /// Arduino pin number of `Pin<N>`. Anything else is not merged by `PinGroup`.
+    template <typename PIN>
+    struct PinNumber
+    {
+        constexpr static bool PLAIN = false;
+        constexpr static uint8_t VALUE = 0;
+    };
+
+    template <uint8_t N>
+    struct PinNumber<Pin<N>>
+    {
+        constexpr static bool PLAIN = true;
+        constexpr static uint8_t VALUE = N;
+    };
+
+    /**
+     * @brief Ports and masks of a `PinGroup`, all resolved at compile time.
+     *
+     * Every port the group touches costs one write per `high()` or `low()` and two per `pulse()`,
+     * however many of its pins sit on it:
+     *
+     * | pins on the port | `high()` / `low()`                      | `pulse()`                |
+     * |------------------|-----------------------------------------|--------------------------|
+     * | one              | `Pin<N>::high()` / `Pin<N>::low()`      | mask to PINx, twice      |
+     * | several          | read, one OR / AND, write, in `cli`     | mask to PINx, twice      |
+     */
+    template <typename... PINS>
+    struct PinGroupPorts
+    {
+        /// Whether every pin is a plain `Pin<N>`, so that its port is known.
+        constexpr static bool MERGED = (PinNumber<PINS>::PLAIN && ...);
+
+        template <Port P>
+        constexpr static uint8_t mask()
+        {
+            return ((pin_to_port<PinNumber<PINS>::VALUE>() == P ? pin_to_mask<PinNumber<PINS>::VALUE>() : 0) | ...);
+        }
+
+        template <Port P>
+        constexpr static uint8_t count()
+        {
+            return ((pin_to_port<PinNumber<PINS>::VALUE>() == P ? 1 : 0) + ...);
+        }
+
+        /// Toggle every pin of the group, one PINx write per port.
+        template <uint8_t P = Port::A>
+        static inline __attribute__((always_inline)) void toggle()
+        {
+            if constexpr (P <= Port::L)
+            {
+                constexpr uint8_t MASK = mask<static_cast<Port>(P)>();
+                if constexpr (MASK != 0)
+                {
+                    *port_to_input<static_cast<Port>(P)>() = MASK;
+                }
+                toggle<P + 1>();
+            }
+        }
+
+        template <uint8_t P = Port::A>
+        static inline __attribute__((always_inline)) void high()
+        {
+            if constexpr (P <= Port::L)
+            {
+                constexpr uint8_t MASK = mask<static_cast<Port>(P)>();
+                if constexpr (count<static_cast<Port>(P)>() == 1)
+                {
+                    (write<P, PINS, true>(), ...);
+                }
+                else if constexpr (MASK != 0)
+                {
+                    const uint8_t sreg = SREG;
+                    cli();
+                    *port_to_output<static_cast<Port>(P)>() |= MASK;
+                    SREG = sreg;
+                }
+                high<P + 1>();
+            }
+        }
+
+        template <uint8_t P = Port::A>
+        static inline __attribute__((always_inline)) void low()
+        {
+            if constexpr (P <= Port::L)
+            {
+                constexpr uint8_t MASK = mask<static_cast<Port>(P)>();
+                if constexpr (count<static_cast<Port>(P)>() == 1)
+                {
+                    (write<P, PINS, false>(), ...);
+                }
+                else if constexpr (MASK != 0)
+                {
+                    const uint8_t sreg = SREG;
+                    cli();
+                    *port_to_output<static_cast<Port>(P)>() &= static_cast<uint8_t>(~MASK);
+                    SREG = sreg;
+                }
+                low<P + 1>();
+            }
+        }
+
+    private:
+        /// Single instruction write of `PIN` if it is the only pin of the group on port `P`.
+        template <uint8_t P, typename PIN, bool LEVEL>
+        static inline __attribute__((always_inline)) void write()
+        {
+            if constexpr (pin_to_port<PinNumber<PIN>::VALUE>() == P)
+            {
+                if constexpr (LEVEL)
+                {
+                    PIN::high();
+                }
+                else
+                {
+                    PIN::low();
+                }
+            }
+        }
+    };
+}
+
+/**
+ * Both halves of the pulse toggle all pins through PINx, so the pins have to be low before, as
+ * for `Pin<N>::pulse()`.
+ */
+template <typename... PINS>
+inline __attribute__((always_inline)) void PinGroup<PINS...>::pulse()
+{
+    using Ports = internal::PinGroupPorts<PINS...>;
+    if constexpr (Ports::MERGED)
+    {
+        Ports::toggle();
+        Ports::toggle();
+    }
+    else
+    {
+        (PINS::high(), ...);
+        (PINS::low(), ...);
+    }
+}
+
+template <typename... PINS>
+inline __attribute__((always_inline)) void PinGroup<PINS...>::high()
+{
+    using Ports = internal::PinGroupPorts<PINS...>;
+    if constexpr (Ports::MERGED)
+    {
+        Ports::high();
+    }
+    else
+    {
+        (PINS::high(), ...);
+    }
+}
+
+template <typename... PINS>
+inline __attribute__((always_inline)) void PinGroup<PINS...>::low()
+{
+    using Ports = internal::PinGroupPorts<PINS...>;
+    if constexpr (Ports::MERGED)
+    {
+        Ports::low();
+    }
+    else
+    {
+        (PINS::low(), ...);
+    }
+}
+
+#endif
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace internal
+{
+    /**
+     * @brief Pin on a GPIO port with a bit set/reset register, as on every STM32 family.
+     *
+     * Writing a bit of the low half of BSRR drives the pin high, the same bit in the high half drives
+     * it low, and all other pins of the port keep their level. Each `high()` or `low()` is a single
+     * store, with no read-modify-write and no interrupt masking.
+     *
+     * The Arduino cores map pin numbers to ports through tables, so the port and mask can not be
+     * constants. They are looked up once during static initialization, before `setup()`, and every
+     * write only loads them.
+     *
+     * @tparam PIN Arduino pin number.
+     * @tparam BANK Pin mapping of the core: `Gpio` is the port register block, `port(pin)` and
+     * `mask(pin)` look up the port and the bit of a pin.
+     */
+    template <uint8_t PIN, typename BANK>
+    class BsrrPin
+    {
+        using Gpio = typename BANK::Gpio;
+
+        static Gpio *const gpio;
+        static const uint32_t bits;
+
+    public:
+        BsrrPin() = delete;
+
+        static inline __attribute__((always_inline)) void high()
+        {
+            gpio->BSRR = bits;
+        }
+
+        static inline __attribute__((always_inline)) void low()
+        {
+            gpio->BSRR = bits << 16;
+        }
+    };
+
+    template <uint8_t PIN, typename BANK>
+    typename BANK::Gpio *const BsrrPin<PIN, BANK>::gpio = BANK::port(PIN);
+
+    template <uint8_t PIN, typename BANK>
+    const uint32_t BsrrPin<PIN, BANK>::bits = BANK::mask(PIN);
+
+    /**
+     * @brief Pin on a port with separate output set and clear registers, as on SAMD.
+     *
+     * A one written to OUTSET drives the pin high, a one written to OUTCLR drives it low, zeros leave
+     * the other pins alone. Port and mask are looked up once, as for `BsrrPin`.
+     *
+     * @tparam PIN Arduino pin number.
+     * @tparam BANK Pin mapping of the core: `Group` is the port register block, `port(pin)` and
+     * `mask(pin)` look up the port and the bit of a pin.
+     */
+    template <uint8_t PIN, typename BANK>
+    class SetClearPin
+    {
+        using Group = typename BANK::Group;
+
+        static Group *const group;
+        static const uint32_t bits;
+
+    public:
+        SetClearPin() = delete;
+
+        static inline __attribute__((always_inline)) void high()
+        {
+            group->OUTSET.reg = bits;
+        }
+
+        static inline __attribute__((always_inline)) void low()
+        {
+            group->OUTCLR.reg = bits;
+        }
+    };
+
+    template <uint8_t PIN, typename BANK>
+    typename BANK::Group *const SetClearPin<PIN, BANK>::group = BANK::port(PIN);
+
+    template <uint8_t PIN, typename BANK>
+    const uint32_t SetClearPin<PIN, BANK>::bits = BANK::mask(PIN);
+}
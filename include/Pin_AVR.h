@@ -51,6 +51,81 @@ namespace internal
         }
     }
 
+    template <Port P>
+    constexpr inline volatile uint8_t *port_to_input()
+    {
+        switch (P)
+        {
+        case A:
+            return &PINA;
+        case B:
+            return &PINB;
+        case C:
+            return &PINC;
+        case D:
+            return &PIND;
+        case E:
+            return &PINE;
+        case F:
+            return &PINF;
+        case G:
+            return &PING;
+        case H:
+            return &PINH;
+        case J:
+            return &PINJ;
+        case K:
+            return &PINK;
+        case L:
+            return &PINL;
+        }
+    }
+
+    /**
+     * @brief Data space address of PINx on the ATmega2560. DDRx follows at +1 and PORTx at +2.
+     *
+     * Plain numbers instead of the `PINx` macros, so inline assembly can take them as immediates.
+     */
+    template <Port P>
+    constexpr inline uint16_t port_to_input_address()
+    {
+        switch (P)
+        {
+        case A:
+            return 0x20;
+        case B:
+            return 0x23;
+        case C:
+            return 0x26;
+        case D:
+            return 0x29;
+        case E:
+            return 0x2C;
+        case F:
+            return 0x2F;
+        case G:
+            return 0x32;
+        case H:
+            return 0x100;
+        case J:
+            return 0x103;
+        case K:
+            return 0x106;
+        case L:
+            return 0x109;
+        }
+    }
+
+    /**
+     * @brief Whether the registers of port `P` are among the lower 32 I/O registers that `sbi` and
+     * `cbi` can address. Ports H to L live in extended I/O space.
+     */
+    template <Port P>
+    constexpr inline bool port_in_low_io()
+    {
+        return port_to_input_address<P>() + 2 < 0x40;
+    }
+
     template <uint8_t PIN>
     constexpr inline Port pin_to_port()
     {
@@ -346,6 +421,47 @@ namespace internal
             return _BV(7); // PK 7 ** 69 ** A15
         }
     }
+
+    template <uint8_t PIN>
+    constexpr inline uint8_t pin_to_bit()
+    {
+        uint8_t bit = 0;
+        while ((pin_to_mask<PIN>() >> bit) != 1)
+        {
+            bit++;
+        }
+        return bit;
+    }
+
+    /**
+     * @brief Cycle costs of the writes of `Pin<PIN>` on the ATmega2560, including loading constants.
+     *
+     * | port   | `high()` / `low()`                | `pulse()`                   | pulse high |
+     * |--------|-----------------------------------|-----------------------------|------------|
+     * | A to G | 2 (`sbi` / `cbi`)                 | 4 (`sbi PINx` twice)        | 2          |
+     * | H to L | 8 (`lds`, `ori`, `sts` in `cli`)  | 5 (`ldi`, `sts PINx` twice) | 2          |
+     */
+    template <uint8_t PIN>
+    struct PinCycles
+    {
+        constexpr static bool LOW_IO = port_in_low_io<pin_to_port<PIN>()>();
+
+        constexpr static uint8_t WRITE = LOW_IO ? 2 : 8;
+        constexpr static uint8_t PULSE = LOW_IO ? 4 : 5;
+        constexpr static uint8_t PULSE_HIGH = 2;
+    };
+}
+
+template <uint8_t PIN>
+constexpr uint8_t Pin<PIN>::writeCycles()
+{
+    return internal::PinCycles<PIN>::WRITE;
+}
+
+template <uint8_t PIN>
+constexpr uint8_t Pin<PIN>::pulseCycles()
+{
+    return internal::PinCycles<PIN>::PULSE;
 }
 
 template <uint8_t PIN>
@@ -354,23 +470,111 @@ void Pin<PIN>::init()
     pinMode(PIN, OUTPUT);
 }
 
+/**
+ * Writing a one to PINx toggles the pin, so the pulse is two single-instruction writes that never
+ * touch the other bits of the port, on every port. The pin has to be low before.
+ */
 template <uint8_t PIN>
 void inline __attribute__((always_inline)) Pin<PIN>::pulse()
 {
-    high();
-    low();
+    constexpr internal::Port PORT = internal::pin_to_port<PIN>();
+    constexpr uint16_t PIN_ADDRESS = internal::port_to_input_address<PORT>();
+
+    if constexpr (internal::port_in_low_io<PORT>())
+    {
+        asm volatile(
+            "sbi %[pin], %[bit]"
+            "\n\t"
+            "sbi %[pin], %[bit]"
+            :
+            : [pin] "I"(PIN_ADDRESS - 0x20),
+              [bit] "I"(internal::pin_to_bit<PIN>())
+            : "memory");
+    }
+    else
+    {
+        asm volatile(
+            "sts %[pin], %[mask]"
+            "\n\t"
+            "sts %[pin], %[mask]"
+            :
+            : [pin] "n"(PIN_ADDRESS),
+              [mask] "d"(internal::pin_to_mask<PIN>())
+            : "memory");
+    }
 }
 
 template <uint8_t PIN>
 void inline __attribute__((always_inline)) Pin<PIN>::high()
 {
-    *internal::port_to_output<internal::pin_to_port<PIN>()>() |= internal::pin_to_mask<PIN>();
+    constexpr internal::Port PORT = internal::pin_to_port<PIN>();
+    constexpr uint16_t PORT_ADDRESS = internal::port_to_input_address<PORT>() + 2;
+
+    if constexpr (internal::port_in_low_io<PORT>())
+    {
+        asm volatile("sbi %[port], %[bit]"
+                     :
+                     : [port] "I"(PORT_ADDRESS - 0x20),
+                       [bit] "I"(internal::pin_to_bit<PIN>())
+                     : "memory");
+    }
+    else
+    {
+        // no single instruction reaches extended I/O, keep interrupts out of the read-modify-write
+        uint8_t value;
+        asm volatile(
+            "in __tmp_reg__, __SREG__"
+            "\n\t"
+            "cli"
+            "\n\t"
+            "lds %[value], %[port]"
+            "\n\t"
+            "ori %[value], %[mask]"
+            "\n\t"
+            "sts %[port], %[value]"
+            "\n\t"
+            "out __SREG__, __tmp_reg__"
+            : [value] "=&d"(value)
+            : [port] "n"(PORT_ADDRESS),
+              [mask] "M"(internal::pin_to_mask<PIN>())
+            : "memory");
+    }
 }
 
 template <uint8_t PIN>
 void inline __attribute__((always_inline)) Pin<PIN>::low()
 {
-    *internal::port_to_output<internal::pin_to_port<PIN>()>() &= ~internal::pin_to_mask<PIN>();
+    constexpr internal::Port PORT = internal::pin_to_port<PIN>();
+    constexpr uint16_t PORT_ADDRESS = internal::port_to_input_address<PORT>() + 2;
+
+    if constexpr (internal::port_in_low_io<PORT>())
+    {
+        asm volatile("cbi %[port], %[bit]"
+                     :
+                     : [port] "I"(PORT_ADDRESS - 0x20),
+                       [bit] "I"(internal::pin_to_bit<PIN>())
+                     : "memory");
+    }
+    else
+    {
+        uint8_t value;
+        asm volatile(
+            "in __tmp_reg__, __SREG__"
+            "\n\t"
+            "cli"
+            "\n\t"
+            "lds %[value], %[port]"
+            "\n\t"
+            "andi %[value], %[mask]"
+            "\n\t"
+            "sts %[port], %[value]"
+            "\n\t"
+            "out __SREG__, __tmp_reg__"
+            : [value] "=&d"(value)
+            : [port] "n"(PORT_ADDRESS),
+              [mask] "M"(static_cast<uint8_t>(~internal::pin_to_mask<PIN>()))
+            : "memory");
+    }
 }
 
 #endif
\ No newline at end of file
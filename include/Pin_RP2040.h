@@ -0,0 +1,39 @@
+#pragma once
+
+#if defined(ARDUINO_ARCH_RP2040) && !defined(ARDUINO_ARCH_MBED)
+
+#include "Pin.h"
+
+#include <Arduino.h>
+#include <hardware/structs/sio.h>
+
+template <uint8_t PIN>
+void Pin<PIN>::init()
+{
+    pinMode(PIN, OUTPUT);
+}
+
+template <uint8_t PIN>
+void inline __attribute__((always_inline)) Pin<PIN>::pulse()
+{
+    high();
+    low();
+}
+
+/**
+ * On the Arduino-Pico core pin numbers are GPIO numbers, so the mask is a constant and every write
+ * is a single store to the SIO set or clear register.
+ */
+template <uint8_t PIN>
+void inline __attribute__((always_inline)) Pin<PIN>::high()
+{
+    sio_hw->gpio_set = 1ul << PIN;
+}
+
+template <uint8_t PIN>
+void inline __attribute__((always_inline)) Pin<PIN>::low()
+{
+    sio_hw->gpio_clr = 1ul << PIN;
+}
+
+#endif
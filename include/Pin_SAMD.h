@@ -0,0 +1,54 @@
+#pragma once
+
+#ifdef ARDUINO_ARCH_SAMD
+
+#include "Pin.h"
+#include "PinRegisters.h"
+
+#include <Arduino.h>
+
+namespace internal
+{
+    /// Pin mapping of the SAMD core.
+    struct SamdPinBank
+    {
+        using Group = PortGroup;
+
+        static Group *port(const uint8_t pin)
+        {
+            return digitalPinToPort(pin);
+        }
+
+        static uint32_t mask(const uint8_t pin)
+        {
+            return digitalPinToBitMask(pin);
+        }
+    };
+}
+
+template <uint8_t PIN>
+void Pin<PIN>::init()
+{
+    pinMode(PIN, OUTPUT);
+}
+
+template <uint8_t PIN>
+void inline __attribute__((always_inline)) Pin<PIN>::pulse()
+{
+    high();
+    low();
+}
+
+template <uint8_t PIN>
+void inline __attribute__((always_inline)) Pin<PIN>::high()
+{
+    internal::SetClearPin<PIN, internal::SamdPinBank>::high();
+}
+
+template <uint8_t PIN>
+void inline __attribute__((always_inline)) Pin<PIN>::low()
+{
+    internal::SetClearPin<PIN, internal::SamdPinBank>::low();
+}
+
+#endif
@@ -0,0 +1,125 @@
+#ifndef RAMP_SET_H
+#define RAMP_SET_H
+
+#include <stdint.h> // NOLINT(modernize-deprecated-headers)
+#include "FixedSpeed.h"
+
+/// @brief Type of the `I`-th ramp of a `RampSet`.
+template<uint8_t I, typename HEAD, typename... REST>
+struct RampSetAt {
+    using type = typename RampSetAt<I - 1, REST...>::type;
+};
+
+template<typename HEAD, typename... REST>
+struct RampSetAt<0, HEAD, REST...> {
+    using type = HEAD;
+};
+
+/// @brief Maps a runtime profile index onto the static functions of the matching ramp.
+///
+/// The last ramp is the fallback for out-of-range indices, so every lookup yields a valid ramp.
+template<uint8_t I, typename HEAD, typename... REST>
+struct RampSetDispatch {
+    static inline __attribute__((always_inline)) uint32_t interval(const uint8_t profile, const uint16_t stair) {
+        if constexpr (sizeof...(REST) == 0) {
+            return HEAD::interval(stair);
+        } else {
+            return (profile == I) ? HEAD::interval(stair) : RampSetDispatch<I + 1, REST...>::interval(profile, stair);
+        }
+    }
+
+    static inline __attribute__((always_inline)) uint8_t stepsPerStair(const uint8_t profile) {
+        if constexpr (sizeof...(REST) == 0) {
+            return HEAD::STEPS_PER_STAIR;
+        } else {
+            return (profile == I) ? HEAD::STEPS_PER_STAIR : RampSetDispatch<I + 1, REST...>::stepsPerStair(profile);
+        }
+    }
+
+    static inline uint16_t stairForInterval(const uint8_t profile, const uint32_t interval) {
+        if constexpr (sizeof...(REST) == 0) {
+            return HEAD::maxAccelStairsForInterval(interval);
+        } else {
+            return (profile == I) ? HEAD::maxAccelStairsForInterval(interval)
+                                  : RampSetDispatch<I + 1, REST...>::stairForInterval(profile, interval);
+        }
+    }
+};
+
+/// @brief Several ramp profiles that share one `Stepper` and therefore one axis state.
+///
+/// A `Stepper` over a `RampSet` keeps a single position, direction and ramp stair, and selects the
+/// profile per move through `move<PROFILE>()` and its siblings. Switching profiles while moving
+/// maps the current speed onto the highest stair of the new profile that is not faster, so the
+/// axis neither stops nor loses position. If the new profile cannot run as fast as the axis
+/// currently moves, the stepper first decelerates on the old profile.
+///
+/// The set itself is stateless. The profile index lives in the `Stepper`, which passes it to the
+/// indexed functions below. The non-indexed speed functions use profile 0, so plain `move()` calls
+/// run on the first ramp.
+///
+/// @tparam RAMPS ramp types, e.g. `AccelerationRamp` or `DynamicRamp`, in profile index order
+///
+template<typename... RAMPS>
+class RampSet {
+    static_assert(sizeof...(RAMPS) > 0, "A ramp set needs at least one ramp");
+    static_assert(sizeof...(RAMPS) <= UINT8_MAX, "A ramp set can hold at most 255 ramps");
+
+    using Dispatch = RampSetDispatch<0, RAMPS...>;
+
+public:
+    RampSet() = delete;
+
+    constexpr static uint8_t PROFILES = sizeof...(RAMPS);
+
+    /// @brief Ramp type of profile `I`.
+    template<uint8_t I>
+    using Profile = typename RampSetAt<I, RAMPS...>::type;
+
+    /// @brief Ramp used by the non-indexed functions.
+    using Default = Profile<0>;
+
+    static inline __attribute__((always_inline)) uint32_t interval(const uint8_t profile, const uint16_t stair) {
+        return Dispatch::interval(profile, stair);
+    }
+
+    static inline __attribute__((always_inline)) uint8_t stepsPerStair(const uint8_t profile) {
+        return Dispatch::stepsPerStair(profile);
+    }
+
+    /// @brief Highest stair of `profile` that is not faster than `interval`.
+    static inline uint16_t stairForInterval(const uint8_t profile, const uint32_t interval) {
+        return Dispatch::stairForInterval(profile, interval);
+    }
+
+    /// @brief Highest stair `profile` can reach.
+    static inline uint16_t topStair(const uint8_t profile) {
+        return Dispatch::stairForInterval(profile, 0);
+    }
+
+    static inline uint32_t getIntervalForSpeed(const float sps) {
+        return Default::getIntervalForSpeed(sps);
+    }
+
+    static inline uint32_t getIntervalForSpeed(const FixedSpeed speed) {
+        return Default::getIntervalForSpeed(speed);
+    }
+
+    static inline uint16_t getIntervalFractionForSpeed(const float sps) {
+        return Default::getIntervalFractionForSpeed(sps);
+    }
+
+    static inline uint16_t getIntervalFractionForSpeed(const FixedSpeed speed) {
+        return Default::getIntervalFractionForSpeed(speed);
+    }
+
+    static inline uint16_t maxAccelStairs(const float sps) {
+        return Default::maxAccelStairs(sps);
+    }
+
+    static inline uint16_t maxAccelStairsForInterval(const uint32_t interval) {
+        return Default::maxAccelStairsForInterval(interval);
+    }
+};
+
+#endif // RAMP_SET_H
@@ -0,0 +1,213 @@
+#ifndef S_CURVE_RAMP_H
+#define S_CURVE_RAMP_H
+
+#include <stdint.h> // NOLINT(modernize-deprecated-headers)
+#include "AccelerationRamp.h"
+#include "NewtonRaphson.h"
+
+/// @brief Jerk-limited (S-curve) counterpart of `AccelerationRamp`.
+///
+/// The acceleration rises linearly with `JERK` up to `ACCELERATION`, stays there if the profile is
+/// long enough, and falls back to zero when `MAX_SPEED` is reached. The interval table samples that
+/// velocity curve at equally spaced distances, exactly like `AccelerationRamp` samples a constant
+/// acceleration, so `Stepper` can use both ramp types interchangeably.
+///
+/// Only the full profile up to `MAX_SPEED` is jerk-limited. A move that peaks on a lower stair runs
+/// and decelerates along the same table, so it starts its constant-speed phase with the
+/// acceleration of that stair.
+///
+/// @tparam STAIRS amount of speed stairs to be used during acceleration and/or deceleration
+/// @tparam T_FREQ frequency of the used timer in Hz
+/// @tparam MAX_SPEED maximal possible speed in steps/s
+/// @tparam ACCELERATION maximal possible acceleration in steps/s/s
+/// @tparam JERK maximal possible change of acceleration in steps/s/s/s
+///
+template<uint16_t STAIRS, uint32_t T_FREQ, uint32_t MAX_SPEED, uint32_t ACCELERATION, uint32_t JERK>
+class SCurveRamp {
+    template<typename T>
+    constexpr static inline __attribute__((always_inline)) bool is_pow2(const T value) {
+        return (value & (value - 1)) == 0;
+    }
+
+    static_assert(STAIRS > 0, "Amount of stairs has to be at least 1");
+    static_assert(STAIRS <= UINT16_MAX / 2, "Amount of stairs has to be at most 2^15");
+    static_assert(is_pow2(STAIRS), "Amount of stairs has to be power of 2");
+
+    static_assert(T_FREQ > 0, "Timer frequency has to be greater than zero");
+
+    static_assert(MAX_SPEED > 0, "Max speed has to be greater than zero");
+
+    static_assert(ACCELERATION > 0, "Acceleration has to be greater than zero");
+
+    static_assert(JERK > 0, "Jerk has to be greater than zero");
+
+    template<typename T>
+    constexpr static inline float f(T value)
+    {
+        return static_cast<float>(value);
+    }
+
+    constexpr static inline float absf(const float value)
+    {
+        return (value < 0.0f) ? -value : value;
+    }
+
+    // A profile that is too short for the full acceleration never leaves the two jerk phases.
+    constexpr static bool REACHES_ACCELERATION = f(MAX_SPEED) * f(JERK) >= f(ACCELERATION) * f(ACCELERATION);
+
+    /// Duration of each of the two jerk phases.
+    constexpr static float T_JERK = REACHES_ACCELERATION
+                                        ? f(ACCELERATION) / f(JERK)
+                                        : NewtonRaphson::sqrt(f(MAX_SPEED) / f(JERK));
+    /// Duration of the constant acceleration phase between the jerk phases.
+    constexpr static float T_CONST = REACHES_ACCELERATION
+                                         ? f(MAX_SPEED) / f(ACCELERATION) - T_JERK
+                                         : 0.0f;
+    /// Duration of the whole profile.
+    constexpr static float T_TOTAL = 2.0f * T_JERK + T_CONST;
+
+    /// Highest acceleration that is actually reached.
+    constexpr static float A_PEAK = f(JERK) * T_JERK;
+
+    constexpr static float V_JERK = 0.5f * f(JERK) * T_JERK * T_JERK;
+    constexpr static float S_JERK = f(JERK) * T_JERK * T_JERK * T_JERK / 6.0f;
+    constexpr static float V_CONST = V_JERK + A_PEAK * T_CONST;
+    constexpr static float S_CONST = S_JERK + V_JERK * T_CONST + 0.5f * A_PEAK * T_CONST * T_CONST;
+
+    /// @brief Distance covered after `t` seconds of the profile.
+    constexpr static float distanceAt(const float t) {
+        if (t <= T_JERK) {
+            return f(JERK) * t * t * t / 6.0f;
+        }
+        if (t <= T_JERK + T_CONST) {
+            const float dt = t - T_JERK;
+            return S_JERK + V_JERK * dt + 0.5f * A_PEAK * dt * dt;
+        }
+        const float dt = ((t < T_TOTAL) ? t : T_TOTAL) - T_JERK - T_CONST;
+        return S_CONST + V_CONST * dt + 0.5f * A_PEAK * dt * dt - f(JERK) * dt * dt * dt / 6.0f;
+    }
+
+    /// @brief Time at which the profile has covered `s`, found by bisection of `distanceAt()`.
+    constexpr static float timeAt(const float s) {
+        float lo = 0.0f;
+        float hi = T_TOTAL;
+        for (uint8_t i = 0; i < 48; ++i) {
+            const float mid = 0.5f * (lo + hi);
+            if (distanceAt(mid) < s) {
+                lo = mid;
+            } else {
+                hi = mid;
+            }
+        }
+        return 0.5f * (lo + hi);
+    }
+
+    constexpr static float MAX_STEPS_IDEAL = distanceAt(T_TOTAL);
+
+    constexpr static uint8_t floor_pow2_u8(const uint8_t value) {
+        for (unsigned int i = 1; i < 256; i *= 2) {
+            if (value >= i && value < i * 2) {
+                return i;
+            }
+        }
+        return UINT8_MAX;
+    }
+
+public:
+    /// Distance of one stair the interval table was sampled with.
+    constexpr static float STEPS_PER_STAIR_IDEAL = MAX_STEPS_IDEAL / STAIRS;
+
+private:
+    static_assert(STEPS_PER_STAIR_IDEAL <= UINT8_MAX);
+
+    // Like `AccelerationRamp`, every interval is the average step time over its stair. Close to
+    // MAX_SPEED neighbouring stairs differ by less than the float resolution of `timeAt()`, so the
+    // result is clamped to stay monotonic and never faster than MAX_SPEED.
+    constexpr static Intervals<STAIRS> calculateIntervals() {
+        Intervals<STAIRS> result = {};
+        result[0] = UINT32_MAX;
+        float t_prev = timeAt(STEPS_PER_STAIR_IDEAL);
+        for (uint16_t i = 1; i < STAIRS; ++i) {
+            const float t_next = (i + 1 < STAIRS) ? timeAt(STEPS_PER_STAIR_IDEAL * f(i + 1)) : T_TOTAL;
+            auto value = (uint32_t) (f(T_FREQ) * (t_next - t_prev) / STEPS_PER_STAIR_IDEAL);
+            if (value > result[i - 1]) {
+                value = result[i - 1];
+            }
+            if (value < T_FREQ / MAX_SPEED) {
+                value = T_FREQ / MAX_SPEED;
+            }
+            result[i] = value;
+            t_prev = t_next;
+        }
+        return result;
+    }
+
+public:
+    SCurveRamp() = delete;
+
+    constexpr static Intervals<STAIRS> intervals = calculateIntervals();
+    static_assert(intervals[0] > 0);
+
+    constexpr static uint16_t STAIRS_COUNT = STAIRS;
+
+    constexpr static uint8_t STEPS_PER_STAIR = floor_pow2_u8((uint8_t) STEPS_PER_STAIR_IDEAL);
+
+    constexpr static uint32_t STEPS_TOTAL = static_cast<uint32_t>(STAIRS_COUNT - 1) * STEPS_PER_STAIR;
+
+    static_assert(STEPS_PER_STAIR > 0, "Amount of steps per stair has to be greater than zero");
+    static_assert(STEPS_PER_STAIR <= 128, "Amount of steps per stair has to be at most 128");
+    static_assert(is_pow2(STEPS_PER_STAIR), "Amount of steps per stair has to be power of 2");
+
+    static constexpr inline __attribute__((always_inline)) uint32_t interval(const uint16_t stair) {
+        return intervals[stair];
+    }
+
+    static constexpr inline __attribute__((always_inline)) uint32_t getIntervalForSpeed(const float sps) {
+        return static_cast<uint32_t>(T_FREQ / absf(sps));
+    }
+
+    static constexpr inline __attribute__((always_inline)) uint32_t getIntervalForSpeed(const FixedSpeed speed) {
+        return speed.interval<T_FREQ>();
+    }
+
+    /// @brief Fraction of a tick truncated by `getIntervalForSpeed()`, in 1/65536 ticks.
+    static constexpr inline uint16_t getIntervalFractionForSpeed(const float sps) {
+        const float exact = T_FREQ / absf(sps);
+        return static_cast<uint16_t>((exact - static_cast<float>(static_cast<uint32_t>(exact))) * 65536.0f);
+    }
+
+    static constexpr inline uint16_t getIntervalFractionForSpeed(const FixedSpeed speed) {
+        return speed.intervalFraction<T_FREQ>();
+    }
+
+    /// @brief Highest stair that is not faster than `interval`.
+    static constexpr inline uint16_t maxAccelStairsForInterval(const uint32_t interval) {
+        return intervals.stairFor(interval);
+    }
+
+    /// @brief Highest stair whose speed does not exceed `sps`.
+    ///
+    /// The S-curve has no closed-form inverse that is cheap at runtime, so the stair is found by a
+    /// binary search over the interval table.
+    static constexpr uint16_t maxAccelStairs(const float sps) {
+        const float speed = absf(sps);
+
+        if (speed >= MAX_SPEED) {
+            return STAIRS - 1;
+        }
+
+        uint16_t lo = 0;
+        uint16_t hi = STAIRS - 1;
+        while (lo < hi) {
+            const uint16_t mid = static_cast<uint16_t>((lo + hi + 1) / 2);
+            if (f(T_FREQ) / f(intervals[mid]) <= speed) {
+                lo = mid;
+            } else {
+                hi = static_cast<uint16_t>(mid - 1);
+            }
+        }
+        return lo;
+    }
+};
+
+#endif // S_CURVE_RAMP_H
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <stdint.h> // NOLINT(modernize-deprecated-headers)
+
+#if !defined(ARDUINO)
+#include <atomic>
+#endif
+
+/**
+ * @brief Sequence counter that lets readers copy state without masking interrupts.
+ *
+ * The writer makes the counter odd before it changes the protected state and even again afterwards.
+ * A reader remembers the counter, copies the state and retries if the counter changed in between,
+ * so a copy is only accepted if no write overlapped it. Nested write sections only count once.
+ *
+ * On AVR and other single-core targets the writer is the interrupt handler, which always runs to
+ * completion before the main loop continues. A reader therefore only ever observes an odd counter
+ * if it preempted a writer itself, e.g. from a callback of another interrupt. Waiting would never
+ * end in that case, so the copy is taken as it is, which is what a reader with masked interrupts
+ * would have gotten as well. On host builds readers and writer may be different threads, so the
+ * counter is atomic, the usual acquire/release fences order the copy, and odd counters are waited
+ * out.
+ *
+ * The protected fields themselves stay `volatile`. Single-byte fields that are updated on their own,
+ * like a step counter within a block, need no write section, because any value read together with
+ * an unchanged counter is consistent with the rest of the copy.
+ */
+class SeqLock
+{
+private:
+#if defined(ARDUINO)
+    volatile uint8_t sequence = 0;
+#else
+    std::atomic<uint32_t> sequence{0};
+#endif
+    uint8_t depth = 0;
+
+public:
+#if defined(ARDUINO)
+    using Token = uint8_t;
+#else
+    using Token = uint32_t;
+#endif
+
+    inline __attribute__((always_inline)) void writeBegin()
+    {
+        if (depth++ == 0)
+        {
+#if defined(ARDUINO)
+            sequence = sequence + 1;
+#else
+            sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+#endif
+        }
+    }
+
+    inline __attribute__((always_inline)) void writeEnd()
+    {
+        if (--depth == 0)
+        {
+#if defined(ARDUINO)
+            sequence = sequence + 1;
+#else
+            sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+#endif
+        }
+    }
+
+    /**
+     * @brief Start a read. Pass the result to `retry()` once the state is copied.
+     */
+    inline Token readBegin() const
+    {
+#if defined(ARDUINO)
+        return sequence;
+#else
+        Token token = sequence.load(std::memory_order_acquire);
+        while ((token & 1U) != 0)
+        {
+            token = sequence.load(std::memory_order_acquire);
+        }
+        return token;
+#endif
+    }
+
+    /**
+     * @brief Return whether a write overlapped the copy that started with `token`.
+     */
+    inline bool retry(const Token token) const
+    {
+#if defined(ARDUINO)
+        return sequence != token;
+#else
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return sequence.load(std::memory_order_relaxed) != token;
+#endif
+    }
+};
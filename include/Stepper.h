@@ -6,11 +6,16 @@
 #ifndef PROFILE_STEPPER_PIN
 #define PROFILE_STEPPER_PIN 45
 #endif
+#ifndef PROFILE_STEPPER_COMMIT_PIN
+#define PROFILE_STEPPER_COMMIT_PIN 46
+#endif
 
 #if PROFILE_STEPPER && defined(ARDUINO)
 #include "Pin.h"
 #define PROFILE_MOVE_BEGIN() Pin<PROFILE_STEPPER_PIN>::high()
 #define PROFILE_MOVE_END() Pin<PROFILE_STEPPER_PIN>::low()
+#define PROFILE_COMMIT_BEGIN() Pin<PROFILE_STEPPER_COMMIT_PIN>::high()
+#define PROFILE_COMMIT_END() Pin<PROFILE_STEPPER_COMMIT_PIN>::low()
 #else
 #define PROFILE_MOVE_BEGIN() \
     do                       \
@@ -20,27 +25,25 @@
     do                     \
     {                      \
     } while (0)
-#endif
-
-#ifndef noInterrupts
-#define noInterrupts() \
-    do                 \
-    {                  \
+#define PROFILE_COMMIT_BEGIN() \
+    do                         \
+    {                          \
     } while (0)
-#endif
-
-#ifndef interrupts
-#define interrupts() \
-    do               \
-    {                \
+#define PROFILE_COMMIT_END() \
+    do                       \
+    {                        \
     } while (0)
 #endif
 
 #include <stdint.h> // NOLINT(modernize-deprecated-headers)
 
+#include "etl/circular_buffer.h"
 #include "etl/delegate.h"
 
 #include "AccelerationRamp.h"
+#include "FixedSpeed.h"
+#include "InterruptLock.h"
+#include "SeqLock.h"
 
 /**
  * @brief Number of constant-speed steps tracked as one logical run block.
@@ -51,6 +54,16 @@
  */
 #define RUN_BLOCK_SIZE 128
 
+/**
+ * @brief Capacity of the per-motor lookahead queue used by `enqueue()`.
+ *
+ * The queue is a fixed-size ring buffer, so the value directly determines the static RAM cost per
+ * `Stepper` instantiation and the worst-case length of the backward junction pass in `enqueue()`.
+ */
+#ifndef STEPPER_QUEUE_SIZE
+#define STEPPER_QUEUE_SIZE 8
+#endif
+
 /**
  * @brief Completion callback invoked when a move terminates.
  *
@@ -75,11 +88,17 @@ using StepperCallback = etl::delegate<void()>;
  * the current block are held in `multi_steps_made` so the interrupt handlers can stay short while
  * `getPosition()` and `distanceToGo()` still report the in-flight progress.
  *
+ * Moves can additionally be chained through `enqueue()`. Queued segments in the same direction are
+ * blended at their boundaries: each segment is planned as if it continued past its end by the
+ * distance needed to stop from the junction stair, and the next segment takes over as soon as the
+ * deceleration ramp reaches that stair.
+ *
  * @tparam INTERRUPT Timer backend. It must expose `ID`, `init()`, `stop()`, `setCallback()`, and
  * `setInterval()`.
  * @tparam DRIVER Stepper output backend. It must expose `init()`, `step()`, `dir()`, and
  * `setInverted()`.
- * @tparam RAMP Ramp model that maps speed requests to timer intervals and acceleration stairs.
+ * @tparam RAMP Ramp model that maps speed requests to timer intervals and acceleration stairs. A
+ * `RampSet` makes several ramp profiles share this one axis state, see `move<PROFILE>()`.
  */
 template <typename INTERRUPT, typename DRIVER, typename RAMP>
 class Stepper
@@ -93,13 +112,119 @@ public:
     Stepper() = delete;
 
 private:
+    template <typename U>
+    constexpr static bool is_ramp_set(decltype(U::PROFILES) *)
+    {
+        return true;
+    }
+
+    template <typename U>
+    constexpr static bool is_ramp_set(...)
+    {
+        return false;
+    }
+
+    /// Whether `RAMP` is a `RampSet`. Only then the profile index is consulted at all.
+    constexpr static bool RAMP_SET = is_ramp_set<RAMP>(nullptr);
+
+    template <typename U>
+    constexpr static bool is_coalescing(decltype(U::COALESCE_STEPS) *)
+    {
+        return (U::COALESCE_STEPS > 1) && (U::COALESCE_INTERVAL > 0);
+    }
+
+    template <typename U>
+    constexpr static bool is_coalescing(...)
+    {
+        return false;
+    }
+
+    /// Whether `RAMP` asks for several steps per interrupt at high speed, see `step_burst()`.
+    constexpr static bool COALESCE = is_coalescing<RAMP>(nullptr);
+
+    template <typename U>
+    constexpr static bool has_elapsed(decltype(U::elapsed()) *)
+    {
+        return true;
+    }
+
+    template <typename U>
+    constexpr static bool has_elapsed(...)
+    {
+        return false;
+    }
+
+    static_assert(!COALESCE || has_elapsed<INTERRUPT>(nullptr),
+                  "A ramp with COALESCE_STEPS needs a timer backend with elapsed(), "
+                  "which the Delegate backend and multiplexed timers do not provide");
+
+    template <typename U>
+    constexpr static bool is_deferred_pulse(decltype(U::DEFERRED_PULSE) *)
+    {
+        return U::DEFERRED_PULSE;
+    }
+
+    template <typename U>
+    constexpr static bool is_deferred_pulse(...)
+    {
+        return false;
+    }
+
+    /// Whether `DRIVER` leaves the step pin high until the next step, see `StepPulse::DEFERRED`.
+    constexpr static bool DEFERRED_PULSE = is_deferred_pulse<DRIVER>(nullptr);
+
+    template <typename U>
+    constexpr static bool is_dual_edge(decltype(U::DUAL_EDGE) *)
+    {
+        return U::DUAL_EDGE;
+    }
+
+    template <typename U>
+    constexpr static bool is_dual_edge(...)
+    {
+        return false;
+    }
+
+    template <typename U>
+    constexpr static bool has_move_hooks(decltype(U::moveStarted()) *)
+    {
+        return true;
+    }
+
+    template <typename U>
+    constexpr static bool has_move_hooks(...)
+    {
+        return false;
+    }
+
+    /// Whether `RAMP` wants to know when the stepper leaves and reaches standstill, see `DynamicRamp`.
+    constexpr static bool MOVE_HOOKS = has_move_hooks<RAMP>(nullptr);
+
+    /**
+     * @brief Interrupt handler a move is currently in, one per `..._handler()` function.
+     */
+    enum class Phase : uint8_t
+    {
+        IDLE,
+        PRE_DECELERATE,
+        ACCELERATE,
+        RUN_SLOW,
+        RUN_FULL,
+        RUN_REST,
+        DECELERATE,
+    };
+
     static volatile int32_t pos; ///< Last committed absolute position in steps.
 
     static volatile int8_t run_dir; ///< Direction requested for the upcoming run phase.
     static volatile int8_t cur_dir; ///< Direction currently being stepped. Zero means idle.
     static volatile uint16_t ramp_stair; ///< Active ramp stair. Zero means no accelerated ramp.
+    static volatile uint8_t profile; ///< Active profile of a `RampSet`. Always zero for a single ramp.
 
     static volatile uint32_t run_interval; ///< Timer interval used during the constant-speed run phase.
+    static volatile uint16_t run_fraction; ///< Fractional tick of the run interval in 1/65536 ticks.
+    static volatile uint16_t run_phase; ///< Accumulated `run_fraction`, overflows once per extra tick.
+    static volatile bool run_stretched; ///< Whether the timer currently runs `run_interval + 1`.
 
     static volatile uint16_t pre_decel_stairs_left; ///< Stairs still needed before the requested profile can start.
     static volatile uint16_t accel_stairs_left; ///< Stairs still to climb after pre-deceleration or start-up.
@@ -109,52 +234,172 @@ private:
 
     static volatile uint8_t multi_steps_made; ///< Steps already emitted inside the active stair or block.
 
+    static volatile uint16_t junction_stair; ///< Stair at which the active segment hands over to the queue.
+
+    static volatile uint8_t burst; ///< Steps the next interrupt emits. Only used with a coalescing `RAMP`.
+    static volatile uint32_t burst_gap; ///< Ticks between the steps of the next burst.
+    static volatile uint32_t burst_tail; ///< Ticks from the first to the last step of the previous burst.
+    static volatile bool burst_rearm; ///< Whether the next burst has to program its own period.
+
     static StepperCallback cb_complete; ///< Completion callback consumed by `terminate()`.
 
+    static SeqLock snapshot_lock; ///< Guards the fields copied by `stateSnapshot()`.
+
+    using InterruptLock = ::internal::InterruptLock; ///< Critical sections for the main loop and callbacks.
+
+    /**
+     * @brief One queued move segment together with its precomputed lookahead limit.
+     *
+     * `MovementSpec` is immutable, so the queue stores its own assignable copy of the planner values.
+     */
+    struct QueuedSegment
+    {
+        int32_t steps; ///< Signed relative segment distance in motor steps.
+        uint32_t run_interval; ///< Timer interval used for the constant-speed run phase.
+        uint16_t run_fraction; ///< Fractional tick of `run_interval` in 1/65536 ticks.
+        uint16_t accel_stair; ///< Highest acceleration stair the requested speed may reach.
+        uint8_t profile; ///< Ramp profile the segment runs on.
+        uint16_t exit_stair; ///< Highest stair at the end of this segment from which the rest of the queue can still stop.
+        StepperCallback on_complete; ///< Invoked once the segment boundary has been reached.
+    };
+
+    static etl::circular_buffer<QueuedSegment, STEPPER_QUEUE_SIZE> segments; ///< Segments waiting behind the active one.
+    static volatile uint32_t queued_steps; ///< Sum of the absolute distances of all queued segments.
+
     /**
      * @brief Consistent copy of the volatile planner state.
      *
      * Query helpers use this structure so they can reason about one coherent snapshot instead of a
-     * mix of old and new values while the interrupt handler is running.
+     * mix of old and new values while the interrupt handler is running. Every change to these
+     * fields, except the step counter within a stair or block, happens inside a write section of
+     * `snapshot_lock`.
      */
     struct StateSnapshot
     {
         int32_t pos;
         int8_t cur_dir;
         uint16_t ramp_stair;
+        uint8_t profile;
         uint16_t pre_decel_stairs_left;
         uint16_t accel_stairs_left;
         uint32_t run_steps_left;
         uint32_t run_full_blocks_left;
         uint8_t run_rest_block_steps;
         uint8_t multi_steps_made;
+        uint16_t junction_stair;
+        uint32_t queued_steps;
     };
 
     /**
-     * @brief Copy the volatile state while interrupts are disabled.
+     * @brief Copy the volatile state without masking interrupts.
      *
-     * On embedded targets this prevents tearing between related counters. On desktop test builds
-     * the `noInterrupts()` and `interrupts()` macros collapse to no-ops.
+     * The copy is retried until no stair or block commit of the interrupt handlers overlapped it,
+     * see `SeqLock`. Polling the state from the main loop therefore never delays a step.
      */
     static StateSnapshot stateSnapshot()
     {
-        noInterrupts();
-        const StateSnapshot state = {
-            pos,
-            cur_dir,
-            ramp_stair,
-            pre_decel_stairs_left,
-            accel_stairs_left,
-            run_steps_left,
-            run_full_blocks_left,
-            run_rest_block_steps,
-            multi_steps_made,
-        };
-        interrupts();
+        SeqLock::Token token;
+        StateSnapshot state;
+        do
+        {
+            token = snapshot_lock.readBegin();
+            state = {
+                pos,
+                cur_dir,
+                ramp_stair,
+                profile,
+                pre_decel_stairs_left,
+                accel_stairs_left,
+                run_steps_left,
+                run_full_blocks_left,
+                run_rest_block_steps,
+                multi_steps_made,
+                junction_stair,
+                queued_steps,
+            };
+        } while (snapshot_lock.retry(token));
 
         return state;
     }
 
+    /**
+     * @brief Timer interval of `stair` on the active ramp profile.
+     */
+    static inline __attribute__((always_inline)) uint32_t active_interval(const uint16_t stair)
+    {
+        if constexpr (RAMP_SET)
+        {
+            return RAMP::interval(profile, stair);
+        }
+        else
+        {
+            return RAMP::interval(stair);
+        }
+    }
+
+    /**
+     * @brief Steps per stair of the active ramp profile.
+     */
+    static inline __attribute__((always_inline)) uint8_t active_steps_per_stair()
+    {
+        if constexpr (RAMP_SET)
+        {
+            return RAMP::stepsPerStair(profile);
+        }
+        else
+        {
+            return RAMP::STEPS_PER_STAIR;
+        }
+    }
+
+    /**
+     * @brief Timer interval of `stair` on the given ramp profile.
+     */
+    static inline uint32_t interval_of(const uint8_t ramp_profile, const uint16_t stair)
+    {
+        if constexpr (RAMP_SET)
+        {
+            return RAMP::interval(ramp_profile, stair);
+        }
+        else
+        {
+            return RAMP::interval(stair);
+        }
+    }
+
+    /**
+     * @brief Steps per stair of the given ramp profile.
+     */
+    static inline uint8_t steps_per_stair_of(const uint8_t ramp_profile)
+    {
+        if constexpr (RAMP_SET)
+        {
+            return RAMP::stepsPerStair(ramp_profile);
+        }
+        else
+        {
+            return RAMP::STEPS_PER_STAIR;
+        }
+    }
+
+    /**
+     * @brief Stair of profile `to` that continues the speed of `stair` on profile `from`.
+     *
+     * The result is the highest stair of `to` that is not faster than the current speed. If `to`
+     * can not run that fast at all, its top stair is returned.
+     */
+    static inline uint16_t handover_stair(const uint8_t from, const uint16_t stair, const uint8_t to)
+    {
+        if constexpr (RAMP_SET)
+        {
+            return (from == to || stair == 0) ? stair : RAMP::stairForInterval(to, RAMP::interval(from, stair));
+        }
+        else
+        {
+            return stair;
+        }
+    }
+
     /**
      * @brief Sum only the queued constant-speed run portion of a move.
      *
@@ -175,7 +420,7 @@ private:
      */
     static uint32_t stepsRemaining(const StateSnapshot &state)
     {
-        const uint32_t steps_per_stair = static_cast<uint32_t>(RAMP::STEPS_PER_STAIR);
+        const uint32_t steps_per_stair = static_cast<uint32_t>(steps_per_stair_of(state.profile));
         const uint32_t partial_steps = static_cast<uint32_t>(state.multi_steps_made);
 
         if (state.pre_decel_stairs_left > 0)
@@ -233,6 +478,149 @@ private:
         return 0;
     }
 
+    /**
+     * @brief Return the interrupt handler of a phase, `nullptr` for `Phase::IDLE`.
+     */
+    static inline __attribute__((always_inline)) auto handler_of(const Phase next) -> void (*)()
+    {
+        switch (next)
+        {
+        case Phase::PRE_DECELERATE:
+            return pre_decelerate_multistep_handler;
+        case Phase::ACCELERATE:
+            return accelerate_multistep_handler;
+        case Phase::RUN_SLOW:
+            return run_slow_handler;
+        case Phase::RUN_FULL:
+            return run_full_multistep_handler;
+        case Phase::RUN_REST:
+            return run_rest_multistep_handler;
+        case Phase::DECELERATE:
+            return decelerate_multistep_handler;
+        default:
+            return nullptr;
+        }
+    }
+
+    /**
+     * @brief Switch to another phase by installing its handler as the timer callback.
+     */
+    static inline __attribute__((always_inline)) void enter(const Phase next)
+    {
+        if (COALESCE && next == Phase::IDLE)
+        {
+            burst_tail = 0;
+        }
+        INTERRUPT::setCallback(handler_of(next));
+    }
+
+    /**
+     * @brief Program the timer for steps `interval` ticks apart.
+     *
+     * With a coalescing `RAMP`, intervals up to `RAMP::COALESCE_INTERVAL` are served by one
+     * interrupt per `RAMP::COALESCE_STEPS` steps. Only phases whose step count is a multiple of the
+     * burst may coalesce (`aligned`): ramp stairs and full run blocks. The final partial run block
+     * and slow single-step runs always take one step per interrupt.
+     *
+     * The timer period counts from the first step of the previous burst, so the ticks that burst
+     * spent polling are added in front of the new interval. If that differs from the steady period
+     * of the new burst, the next interrupt programs the steady one after its steps.
+     */
+    static inline __attribute__((always_inline)) void set_step_interval(const uint32_t interval, const bool aligned)
+    {
+        if constexpr (COALESCE)
+        {
+            const uint8_t steps = (aligned && interval <= RAMP::COALESCE_INTERVAL) ? RAMP::COALESCE_STEPS : 1;
+            burst = steps;
+            burst_gap = interval;
+            burst_rearm = burst_tail != interval * (steps - 1);
+            INTERRUPT::setInterval(burst_tail + interval);
+        }
+        else
+        {
+            INTERRUPT::setInterval(interval);
+        }
+    }
+
+    /**
+     * @brief Program the timer for the given stair of the active ramp profile.
+     */
+    static inline __attribute__((always_inline)) void set_stair_interval(const uint16_t stair)
+    {
+        set_step_interval(active_interval(stair), true);
+    }
+
+    /**
+     * @brief Take one step, ending the pulse of the previous one first if the driver defers it.
+     *
+     * The pin is then low only for the time between two port writes, the high phase lasts the
+     * whole interval.
+     */
+    static inline __attribute__((always_inline)) void step_edge()
+    {
+        if constexpr (DEFERRED_PULSE)
+        {
+            DRIVER::release();
+        }
+        DRIVER::step();
+    }
+
+    /**
+     * @brief Emit the steps of one interrupt and return how many were taken.
+     *
+     * Without a coalescing `RAMP` this is a single step. Otherwise the first step is taken right
+     * away and every further step of the burst waits until `burst_gap` more ticks have passed on the
+     * timer, counted from the first one. The interrupt latency therefore shifts the whole burst
+     * evenly instead of shortening the first gap, and the code between the steps needs no
+     * calibration. The timer backend has to expose `elapsed()`, the ticks since the interrupt was
+     * due. A prescaled timer only counts whole prescaled ticks, so there the steps of a burst land
+     * within one prescaled tick of their time.
+     *
+     * A driver with deferred pulses gets the falling edge of the previous step right before each
+     * step. Inside a burst it comes halfway between two steps instead.
+     */
+    static inline __attribute__((always_inline)) uint8_t step_burst()
+    {
+        step_edge();
+
+        if constexpr (COALESCE)
+        {
+            const uint8_t steps = burst;
+            uint32_t due = 0;
+            if (steps > 1)
+            {
+                const uint32_t gap = burst_gap;
+                const uint32_t first = INTERRUPT::elapsed();
+                for (uint8_t i = 1; i < steps; i++)
+                {
+                    if constexpr (DEFERRED_PULSE)
+                    {
+                        while (INTERRUPT::elapsed() - first < due + (gap >> 1))
+                        {
+                        }
+                        DRIVER::release();
+                    }
+                    due += gap;
+                    while (INTERRUPT::elapsed() - first < due)
+                    {
+                    }
+                    DRIVER::step();
+                }
+            }
+            burst_tail = due;
+            if (burst_rearm)
+            {
+                burst_rearm = false;
+                INTERRUPT::setInterval(due + burst_gap);
+            }
+            return steps;
+        }
+        else
+        {
+            return 1;
+        }
+    }
+
     /**
      * @brief Interrupt handler for the initial deceleration phase.
      *
@@ -242,54 +630,69 @@ private:
      */
     static void pre_decelerate_multistep_handler()
     {
-        DRIVER::step();
+        const uint8_t steps = step_burst();
 
         // check if this was last step of a multistep block
-        if (++multi_steps_made == RAMP::STEPS_PER_STAIR)
+        if ((multi_steps_made = multi_steps_made + steps) == active_steps_per_stair())
         {
-            pos += (cur_dir > 0) ? RAMP::STEPS_PER_STAIR : -RAMP::STEPS_PER_STAIR;
+            snapshot_lock.writeBegin();
+
+            pos += (cur_dir > 0) ? active_steps_per_stair() : -active_steps_per_stair();
             multi_steps_made = 0;
 
             // did not reach end of pre-deceleration, switch to next stair
             if (--pre_decel_stairs_left > 0)
             {
-                INTERRUPT::setInterval(RAMP::interval(--ramp_stair));
+                set_stair_interval(--ramp_stair);
+                snapshot_lock.writeEnd();
             }
             // pre-deceleration finished, it was a direction switch, accelerate
             else if (accel_stairs_left > 0)
             {
                 ramp_stair = 1;
                 cur_dir = run_dir;
+                snapshot_lock.writeEnd();
+
                 DRIVER::dir(cur_dir > 0);
 
-                INTERRUPT::setCallback(accelerate_multistep_handler);
-                INTERRUPT::setInterval(RAMP::interval(1));
+                enter(Phase::ACCELERATE);
+                set_stair_interval(1);
             }
             // pre-deceleration finished, no need to accelerate, run
             else
             {
+                // The stair that was just completed is the last one above the requested run speed.
+                --ramp_stair;
+
                 // set dir in case this deceleration was a direction change with a slow run speed afterwards
                 cur_dir = run_dir;
+                snapshot_lock.writeEnd();
+
                 DRIVER::dir(cur_dir > 0);
 
                 if (run_steps_left > 0)
                 {
-                    INTERRUPT::setCallback(run_slow_handler);
-                    INTERRUPT::setInterval(run_interval);
+                    enter(Phase::RUN_SLOW);
+                    set_step_interval(run_interval, false);
                 }
                 else if (run_full_blocks_left > 0)
                 {
-                    INTERRUPT::setCallback(run_full_multistep_handler);
-                    INTERRUPT::setInterval(run_interval);
+                    enter(Phase::RUN_FULL);
+                    set_step_interval(run_interval, true);
                 }
                 else if (run_rest_block_steps > 0)
                 {
-                    INTERRUPT::setCallback(run_rest_multistep_handler);
-                    INTERRUPT::setInterval(run_interval);
+                    enter(Phase::RUN_REST);
+                    set_step_interval(run_interval, false);
+                }
+                else if (ramp_stair == junction_stair)
+                {
+                    complete_segment();
                 }
                 else
                 {
-                    terminate();
+                    enter(Phase::DECELERATE);
+                    set_stair_interval(ramp_stair);
                 }
             }
         }
@@ -303,54 +706,111 @@ private:
      */
     static void accelerate_multistep_handler()
     {
-        DRIVER::step();
+        const uint8_t steps = step_burst();
 
-        if (++multi_steps_made == RAMP::STEPS_PER_STAIR) // last step of multistep block
+        if ((multi_steps_made = multi_steps_made + steps) == active_steps_per_stair()) // last step of multistep block
         {
-            pos += (cur_dir > 0) ? RAMP::STEPS_PER_STAIR : -RAMP::STEPS_PER_STAIR;
+            snapshot_lock.writeBegin();
+
+            pos += (cur_dir > 0) ? active_steps_per_stair() : -active_steps_per_stair();
             multi_steps_made = 0;
 
             // finished acceleration
             if (--accel_stairs_left == 0)
             {
+                snapshot_lock.writeEnd();
+
                 // switch to run phase (full blocks)
                 if (run_full_blocks_left > 0)
                 {
-                    INTERRUPT::setCallback(run_full_multistep_handler);
-                    INTERRUPT::setInterval(run_interval);
+                    enter(Phase::RUN_FULL);
+                    set_step_interval(run_interval, true);
                 }
                 // switch to run phase (rest)
                 else if (run_rest_block_steps > 0)
                 {
-                    INTERRUPT::setCallback(run_rest_multistep_handler);
-                    INTERRUPT::setInterval(run_interval);
+                    enter(Phase::RUN_REST);
+                    set_step_interval(run_interval, false);
+                }
+                // peak stair is the junction into the next queued segment
+                else if (ramp_stair == junction_stair)
+                {
+                    complete_segment();
                 }
                 // decelerate, no run phase needed
                 else
                 {
-                    INTERRUPT::setCallback(decelerate_multistep_handler);
+                    enter(Phase::DECELERATE);
                 }
             }
             // continue acceleration
             else
             {
-                INTERRUPT::setInterval(RAMP::interval(++ramp_stair));
+                set_stair_interval(++ramp_stair);
+                snapshot_lock.writeEnd();
             }
         }
     }
 
+    /**
+     * @brief Stretch the run interval by one tick whenever the accumulated fraction overflows.
+     *
+     * This is a phase accumulator: over 65536 steps exactly `run_fraction` of them take
+     * `run_interval + 1` ticks, so the average rate matches the requested one instead of running
+     * fast by the truncated fraction. Without a fraction the carry never happens and only the add
+     * and the two compares remain.
+     *
+     * With a coalescing `RAMP` the interrupt just served took `taken` steps, so the fraction is
+     * added that many times and the whole carry goes into the gap behind the burst. `next` is the
+     * burst of the following interrupt. The timer is reprogrammed on every burst, which is cheap
+     * next to the steps it covers.
+     */
+    static inline __attribute__((always_inline)) void dither_run_interval(const uint8_t taken = 1, const uint8_t next = 1)
+    {
+        if constexpr (COALESCE)
+        {
+            const uint32_t sum = static_cast<uint32_t>(run_phase) + (static_cast<uint32_t>(run_fraction) * taken);
+            run_phase = static_cast<uint16_t>(sum);
+            burst = next;
+            INTERRUPT::setInterval(burst_tail + run_interval + (sum >> 16));
+            return;
+        }
+
+        const uint16_t fraction = run_fraction;
+        const uint16_t phase = run_phase + fraction;
+        run_phase = phase;
+
+        // the 16 bit sum wrapped around
+        if (phase < fraction)
+        {
+            INTERRUPT::setInterval(run_interval + 1);
+            run_stretched = true;
+        }
+        else if (run_stretched)
+        {
+            INTERRUPT::setInterval(run_interval);
+            run_stretched = false;
+        }
+    }
+
     /**
      * @brief Interrupt handler for low-speed moves that execute one logical step per callback.
      */
     static void run_slow_handler()
     {
-        DRIVER::step();
+        // always a single step, this only retires the tail of a preceding burst
+        step_burst();
+
+        dither_run_interval();
 
+        snapshot_lock.writeBegin();
         pos += cur_dir;
+        const bool finished = --run_steps_left == 0;
+        snapshot_lock.writeEnd();
 
-        if (--run_steps_left == 0)
+        if (finished)
         {
-            terminate();
+            complete_segment();
         }
     }
 
@@ -362,24 +822,29 @@ private:
      */
     static void run_rest_multistep_handler()
     {
-        DRIVER::step();
+        // always a single step, this only retires the tail of a preceding burst
+        step_burst();
+
+        dither_run_interval();
 
         if (++multi_steps_made == run_rest_block_steps)
         {
+            snapshot_lock.writeBegin();
             pos += (cur_dir > 0) ? run_rest_block_steps : -run_rest_block_steps;
             run_rest_block_steps = 0;
             multi_steps_made = 0;
+            snapshot_lock.writeEnd();
 
-            // no deceleration needed
-            if (ramp_stair == 0)
+            // no deceleration needed, either standing still or handing over at the junction stair
+            if (ramp_stair == junction_stair)
             {
-                terminate();
+                complete_segment();
             }
             // decelerate
             else
             {
-                INTERRUPT::setInterval(RAMP::interval(ramp_stair));
-                INTERRUPT::setCallback(decelerate_multistep_handler);
+                set_stair_interval(ramp_stair);
+                enter(Phase::DECELERATE);
             }
         }
     }
@@ -389,29 +854,37 @@ private:
      */
     static void run_full_multistep_handler()
     {
-        DRIVER::step();
+        const uint8_t steps = step_burst();
 
-        if (++multi_steps_made == RUN_BLOCK_SIZE)
+        // the last block hands over to the rest block, which takes one step per interrupt
+        const bool into_rest = COALESCE && (multi_steps_made + steps == RUN_BLOCK_SIZE) &&
+                               (run_full_blocks_left == 1) && (run_rest_block_steps > 0);
+        dither_run_interval(steps, into_rest ? 1 : steps);
+
+        if ((multi_steps_made = multi_steps_made + steps) == RUN_BLOCK_SIZE)
         {
+            snapshot_lock.writeBegin();
             pos += (cur_dir > 0) ? RUN_BLOCK_SIZE : -RUN_BLOCK_SIZE;
             multi_steps_made = 0;
+            const bool last_block = --run_full_blocks_left == 0;
+            snapshot_lock.writeEnd();
 
-            if (--run_full_blocks_left == 0)
+            if (last_block)
             {
                 if (run_rest_block_steps > 0)
                 {
-                    INTERRUPT::setCallback(run_rest_multistep_handler);
+                    enter(Phase::RUN_REST);
                 }
-                // no deceleration needed
-                else if (ramp_stair == 0)
+                // no deceleration needed, either standing still or handing over at the junction stair
+                else if (ramp_stair == junction_stair)
                 {
-                    terminate();
+                    complete_segment();
                 }
                 // decelerate
                 else
                 {
-                    INTERRUPT::setInterval(RAMP::interval(ramp_stair));
-                    INTERRUPT::setCallback(decelerate_multistep_handler);
+                    set_stair_interval(ramp_stair);
+                    enter(Phase::DECELERATE);
                 }
             }
             // continue multistep run
@@ -432,71 +905,225 @@ private:
     {
         // always step first to ensure the best accuracy.
         // other calculations should be done as quick as possible below.
-        DRIVER::step();
+        const uint8_t steps = step_burst();
 
-        if (++multi_steps_made == RAMP::STEPS_PER_STAIR)
+        if ((multi_steps_made = multi_steps_made + steps) == active_steps_per_stair())
         {
-            pos += (cur_dir > 0) ? RAMP::STEPS_PER_STAIR : -RAMP::STEPS_PER_STAIR;
+            snapshot_lock.writeBegin();
+            pos += (cur_dir > 0) ? active_steps_per_stair() : -active_steps_per_stair();
             multi_steps_made = 0;
+            const bool junction = --ramp_stair == junction_stair;
+            snapshot_lock.writeEnd();
 
-            if (--ramp_stair == 0)
+            if (junction)
             {
-                terminate();
+                complete_segment();
             }
             else
             {
-                INTERRUPT::setInterval(RAMP::interval(ramp_stair));
+                set_stair_interval(ramp_stair);
             }
         }
     }
 
-public:
     /**
-     * @brief Initialize the driver backend and the timer backend.
+     * @brief Finish the active segment and continue with the next queued one, if there is any.
+     *
+     * Without queued segments this is the regular natural completion through `terminate()`. With a
+     * queue, the next segment is planned first and the finished segment's callback runs afterwards,
+     * so a callback that issues a new `move()` still overrides the queue.
      */
-    static void init()
+    static void complete_segment()
     {
-        DRIVER::init();
-        INTERRUPT::init();
+        if (segments.empty())
+        {
+            terminate();
+            return;
+        }
+
+        const StepperCallback finished = cb_complete;
+
+        start_next_segment();
+
+        if (finished.is_valid())
+        {
+            finished();
+        }
     }
 
     /**
-     * @brief Abort the current plan immediately and optionally invoke the completion callback.
+     * @brief Pop the oldest queued segment and plan it from the current stair.
      *
-     * This is the hard-stop primitive. Unlike `stop()`, it does not try to decelerate gracefully;
-     * it clears the planner state right away and then calls the stored callback if requested.
+     * The segment is planned with a virtual tail of `junction_stair * STEPS_PER_STAIR` steps, which
+     * is exactly the distance the deceleration ramp needs below the junction stair. The segment
+     * boundary is therefore reached on a stair boundary, where the handlers hand over again.
      */
-    static void terminate(bool callCallback = true)
+    static void start_next_segment()
     {
-        INTERRUPT::stop();
-        INTERRUPT::setCallback(nullptr);
+        const QueuedSegment next = segments.front();
+        segments.pop();
 
-        run_dir = 0;
-        cur_dir = 0;
-        ramp_stair = 0;
+        const uint32_t abs_steps = static_cast<uint32_t>((next.steps >= 0) ? next.steps : -next.steps);
 
-        run_interval = 0;
+        snapshot_lock.writeBegin();
+        queued_steps -= abs_steps;
 
-        pre_decel_stairs_left = 0;
-        accel_stairs_left = 0;
-        run_steps_left = 0;
-        run_full_blocks_left = 0;
-        run_rest_block_steps = 0;
+        // Besides the lookahead limit, the junction must be reachable from the current stair within
+        // this segment's own distance. Both are counted in stairs of the segment's profile.
+        const uint8_t stair_steps = steps_per_stair_of(next.profile);
+        uint16_t junction = 0;
+        if (next.exit_stair > 0)
+        {
+            const uint32_t reachable =
+                static_cast<uint32_t>(handover_stair(profile, ramp_stair, next.profile)) + (abs_steps / static_cast<uint32_t>(stair_steps));
+            junction = (reachable < next.exit_stair) ? static_cast<uint16_t>(reachable) : next.exit_stair;
+        }
+        junction_stair = junction;
 
-        multi_steps_made = 0;
+        const int64_t tail_steps = static_cast<int64_t>(junction) * static_cast<int64_t>(stair_steps);
+        const int64_t virtual_steps = (next.steps >= 0) ? next.steps + tail_steps : next.steps - tail_steps;
+        const int32_t clamped_steps =
+            (virtual_steps > static_cast<int64_t>(INT32_MAX)) ? INT32_MAX
+            : (virtual_steps < -static_cast<int64_t>(INT32_MAX)) ? -INT32_MAX
+                                                               : static_cast<int32_t>(virtual_steps);
 
-        if (callCallback && cb_complete.is_valid())
+        // Handing over already happens in interrupt context, so the plan can be applied directly.
+        const Plan plan =
+            make_plan(cur_dir, ramp_stair, profile, MovementSpec(clamped_steps, next.run_interval, next.accel_stair, next.run_fraction, next.profile), next.on_complete);
+        const bool running = apply(plan);
+        snapshot_lock.writeEnd();
+
+        if (!running)
         {
-            cb_complete();
+            terminate();
         }
-
-        cb_complete = StepperCallback();
     }
 
     /**
-     * @brief Forward the direction inversion flag to the motor driver backend.
+     * @brief Position reported by `getPosition()` for a copy of the state.
      */
-    static void setInverted(bool value)
+    static int32_t position_of(const StateSnapshot &state)
+    {
+        return state.pos + (static_cast<int32_t>(state.multi_steps_made) * static_cast<int32_t>(state.cur_dir));
+    }
+
+    /**
+     * @brief Convert an absolute target into a relative move from `position`.
+     *
+     * The subtraction is guarded against signed 32-bit overflow and clamped to the largest signed
+     * distance the planner can safely store. The planner later takes an absolute value of the
+     * steps, so `INT32_MIN` must be avoided.
+     */
+    static int32_t steps_between(const int32_t position, const int32_t target)
+    {
+        const int64_t relative_steps = static_cast<int64_t>(target) - static_cast<int64_t>(position);
+
+        return (relative_steps > static_cast<int64_t>(INT32_MAX)) ? INT32_MAX
+               : (relative_steps < -static_cast<int64_t>(INT32_MAX)) ? -INT32_MAX
+                                                                   : static_cast<int32_t>(relative_steps);
+    }
+
+    /**
+     * @brief Tell a `RAMP` with move hooks that the stepper left or reached standstill.
+     *
+     * The hooks may count several steppers, so they run with interrupts disabled even when a move
+     * ends or starts from the main loop.
+     */
+    static inline void report_move(const bool started)
+    {
+        if constexpr (MOVE_HOOKS)
+        {
+            const InterruptLock::State irq = InterruptLock::lock();
+            if (started)
+            {
+                RAMP::moveStarted();
+            }
+            else
+            {
+                RAMP::moveEnded();
+            }
+            InterruptLock::unlock(irq);
+        }
+    }
+
+public:
+    /**
+     * @brief Whether `DRIVER` steps on both edges of the step pin, see `StepPulse::DUAL_EDGE`.
+     *
+     * Every `DRIVER::step()` is then a single toggle and the pin level carries no meaning, so a
+     * move terminated at any point leaves nothing to finish: the next step toggles from wherever
+     * the pin is. Drivers without this constant step on one edge.
+     */
+    constexpr static bool DUAL_EDGE = is_dual_edge<DRIVER>(nullptr);
+
+    /**
+     * @brief Initialize the driver backend and the timer backend.
+     */
+    static void init()
+    {
+        DRIVER::init();
+        INTERRUPT::init();
+    }
+
+    /**
+     * @brief Abort the current plan immediately and optionally invoke the completion callback.
+     *
+     * This is the hard-stop primitive. Unlike `stop()`, it does not try to decelerate gracefully;
+     * it clears the planner state right away and then calls the stored callback if requested.
+     */
+    static void terminate(bool callCallback = true)
+    {
+        INTERRUPT::stop();
+        enter(Phase::IDLE);
+
+        const bool was_moving = cur_dir != 0;
+
+        snapshot_lock.writeBegin();
+
+        // steps already taken inside the current stair or block are real, keep them
+        pos += static_cast<int32_t>(multi_steps_made) * cur_dir;
+
+        segments.clear();
+        queued_steps = 0;
+        junction_stair = 0;
+
+        run_dir = 0;
+        cur_dir = 0;
+        ramp_stair = 0;
+        profile = 0;
+
+        run_interval = 0;
+        run_fraction = 0;
+        run_phase = 0;
+        run_stretched = false;
+
+        pre_decel_stairs_left = 0;
+        accel_stairs_left = 0;
+        run_steps_left = 0;
+        run_full_blocks_left = 0;
+        run_rest_block_steps = 0;
+
+        multi_steps_made = 0;
+
+        snapshot_lock.writeEnd();
+
+        if (was_moving)
+        {
+            report_move(false);
+        }
+
+        if (callCallback && cb_complete.is_valid())
+        {
+            cb_complete();
+        }
+
+        cb_complete = StepperCallback();
+    }
+
+    /**
+     * @brief Forward the direction inversion flag to the motor driver backend.
+     */
+    static void setInverted(bool value)
     {
         DRIVER::setInverted(value);
     }
@@ -509,13 +1136,28 @@ public:
      */
     static void reset()
     {
+        if (cur_dir != 0)
+        {
+            report_move(false);
+        }
+
+        snapshot_lock.writeBegin();
+
         pos = 0;
 
+        segments.clear();
+        queued_steps = 0;
+        junction_stair = 0;
+
         cur_dir = 0;
         run_dir = 0;
         ramp_stair = 0;
+        profile = 0;
 
         run_interval = 0;
+        run_fraction = 0;
+        run_phase = 0;
+        run_stretched = false;
 
         pre_decel_stairs_left = 0;
         accel_stairs_left = 0;
@@ -524,6 +1166,8 @@ public:
         run_rest_block_steps = 0;
 
         multi_steps_made = 0;
+
+        snapshot_lock.writeEnd();
     }
 
     /**
@@ -531,9 +1175,7 @@ public:
      */
     static int32_t getPosition()
     {
-        const StateSnapshot state = stateSnapshot();
-
-        return state.pos + (static_cast<int32_t>(state.multi_steps_made) * static_cast<int32_t>(state.cur_dir));
+        return position_of(stateSnapshot());
     }
 
     /**
@@ -544,17 +1186,26 @@ public:
      */
     static void setPosition(const int32_t value)
     {
-        noInterrupts();
+        const InterruptLock::State irq = InterruptLock::lock();
+        snapshot_lock.writeBegin();
         pos = value;
-        interrupts();
+        snapshot_lock.writeEnd();
+        InterruptLock::unlock(irq);
     }
 
     /**
      * @brief Return the non-negative number of steps still queued in the active plan.
+     *
+     * Segments waiting in the lookahead queue are included. The virtual tail that lets the active
+     * segment blend into the next one is not, because those steps belong to the next segment.
      */
     static uint32_t distanceToGo()
     {
-        return stepsRemaining(stateSnapshot());
+        const StateSnapshot state = stateSnapshot();
+        const uint32_t tail_steps =
+            static_cast<uint32_t>(state.junction_stair) * static_cast<uint32_t>(steps_per_stair_of(state.profile));
+
+        return stepsRemaining(state) - tail_steps + state.queued_steps;
     }
 
     /**
@@ -576,6 +1227,8 @@ public:
         const int32_t steps; ///< Signed relative target distance in motor steps.
         const uint32_t run_interval; ///< Timer interval used for the constant-speed run phase.
         const uint16_t accel_stair; ///< Highest acceleration stair the requested speed may reach.
+        const uint16_t run_fraction; ///< Fractional tick of `run_interval` in 1/65536 ticks, see `exact()`.
+        const uint8_t profile; ///< Ramp profile of a `RampSet` the move runs on.
 
         MovementSpec() = delete;
 
@@ -585,9 +1238,13 @@ public:
         constexpr MovementSpec(
             const int32_t steps,
             const uint32_t runInterval,
-            const uint16_t accelStair) : steps(steps),
-                                         run_interval(runInterval),
-                                         accel_stair(accelStair) {}
+            const uint16_t accelStair,
+            const uint16_t runFraction = 0,
+            const uint8_t rampProfile = 0) : steps(steps),
+                                             run_interval(runInterval),
+                                             accel_stair(accelStair),
+                                             run_fraction(runFraction),
+                                             profile(rampProfile) {}
 
         /**
          * @brief Create a move request for a fixed relative distance.
@@ -616,6 +1273,132 @@ public:
             uint16_t full_accel_stairs = RAMP::maxAccelStairs(speed);
             return MovementSpec(steps, run_interval, full_accel_stairs);
         }
+
+        /**
+         * @brief Integer counterpart of `distance()`.
+         *
+         * The acceleration stair is looked up from the run interval instead of being computed
+         * from the speed, so no float operation is involved.
+         */
+        constexpr static MovementSpec distance(const FixedSpeed speed, const int32_t steps)
+        {
+            const uint32_t run_interval = RAMP::getIntervalForSpeed(speed);
+            return MovementSpec(
+                speed.isNegative() ? -steps : steps,
+                run_interval,
+                RAMP::maxAccelStairsForInterval(run_interval));
+        }
+
+        /**
+         * @brief Integer counterpart of `time()`.
+         */
+        constexpr static MovementSpec time(const FixedSpeed speed, const uint32_t time_ms)
+        {
+            const uint32_t run_interval = RAMP::getIntervalForSpeed(speed);
+            return MovementSpec(
+                speed.stepsIn(time_ms),
+                run_interval,
+                RAMP::maxAccelStairsForInterval(run_interval));
+        }
+
+        /**
+         * @brief Like `distance()`, but the run phase keeps the exact average rate.
+         *
+         * The timer interval is a whole number of ticks, so a plain move runs fast by up to one
+         * tick per step. This one also carries the truncated fraction, and the run handlers
+         * alternate between `run_interval` and `run_interval + 1` to make up for it. The long-run
+         * rate is then only off by the 1/65536 tick resolution of the fraction, which is below
+         * 1 ppm for intervals of 16 ticks or more.
+         *
+         * Ramp stairs are not dithered, so only the constant-speed run phase is exact.
+         */
+        constexpr static MovementSpec exact(const float speed, const int32_t steps)
+        {
+            return MovementSpec(
+                (speed >= 0.0f) ? steps : -steps,
+                RAMP::getIntervalForSpeed(speed),
+                RAMP::maxAccelStairs(speed),
+                RAMP::getIntervalFractionForSpeed(speed));
+        }
+
+        /**
+         * @brief Integer counterpart of `exact()`.
+         *
+         * The speed itself is only resolved to one millistep per second, which limits the accuracy
+         * to 1 ppm only from 1000 steps/s on. Use the `float` variant for slower speeds.
+         */
+        constexpr static MovementSpec exact(const FixedSpeed speed, const int32_t steps)
+        {
+            const uint32_t run_interval = RAMP::getIntervalForSpeed(speed);
+            return MovementSpec(
+                speed.isNegative() ? -steps : steps,
+                run_interval,
+                RAMP::maxAccelStairsForInterval(run_interval),
+                RAMP::getIntervalFractionForSpeed(speed));
+        }
+
+        /**
+         * @brief `distance()` on ramp profile `PROFILE` of a `RampSet`.
+         */
+        template <uint8_t PROFILE>
+        constexpr static MovementSpec distance(const float speed, const int32_t steps)
+        {
+            using ProfileRamp = typename RAMP::template Profile<PROFILE>;
+            return MovementSpec(
+                (speed >= 0.0f) ? steps : -steps,
+                ProfileRamp::getIntervalForSpeed(speed),
+                ProfileRamp::maxAccelStairs(speed),
+                0,
+                PROFILE);
+        }
+
+        /**
+         * @brief `exact()` on ramp profile `PROFILE` of a `RampSet`.
+         */
+        template <uint8_t PROFILE>
+        constexpr static MovementSpec exact(const float speed, const int32_t steps)
+        {
+            using ProfileRamp = typename RAMP::template Profile<PROFILE>;
+            return MovementSpec(
+                (speed >= 0.0f) ? steps : -steps,
+                ProfileRamp::getIntervalForSpeed(speed),
+                ProfileRamp::maxAccelStairs(speed),
+                ProfileRamp::getIntervalFractionForSpeed(speed),
+                PROFILE);
+        }
+    };
+
+    /**
+     * @brief Precomputed move produced by `planMove()` and applied by `commit()`.
+     *
+     * A plan is tied to the direction and ramp stair it was computed from. Every other field is a
+     * plain copy of the value the planner state takes on when the plan is committed.
+     */
+    struct Plan
+    {
+        int8_t from_dir; ///< Direction the plan was computed from.
+        uint16_t from_stair; ///< Ramp stair the plan was computed from.
+        uint8_t from_profile; ///< Ramp profile the plan was computed from.
+        bool absolute; ///< Whether the steps count from `from_pos` instead of from the commit.
+        int32_t from_pos; ///< Position an absolute target was converted at.
+
+        uint8_t profile; ///< Ramp profile the plan runs on.
+
+        bool set_dir; ///< Whether the driver direction is switched to `run_dir` on commit.
+        int8_t run_dir; ///< Direction requested for the run phase.
+        uint16_t ramp_stair; ///< Ramp stair the first handler starts on.
+        uint32_t run_interval; ///< Timer interval used during the constant-speed run phase.
+        uint16_t run_fraction; ///< Fractional tick of `run_interval` in 1/65536 ticks.
+        uint16_t pre_decel_stairs_left; ///< Stairs to descend before the requested profile starts.
+        uint16_t accel_stairs_left; ///< Stairs to climb toward the requested speed.
+        uint32_t run_steps_left; ///< Single-step run distance for slow moves.
+        uint32_t run_full_blocks_left; ///< Full constant-speed run blocks.
+        uint8_t run_rest_block_steps; ///< Tail steps after the full run blocks.
+
+        Phase phase; ///< First phase of the move. `Phase::IDLE` ends the move on commit.
+        uint32_t interval; ///< Timer interval until the first handler runs.
+
+        StepperCallback on_complete; ///< Completion callback of the planned move.
     };
 
     /**
@@ -628,15 +1411,24 @@ public:
     {
         INTERRUPT::stop();
 
+        // A controlled stop ends the whole chain, so the ramp has to run all the way down to zero.
+        snapshot_lock.writeBegin();
+        segments.clear();
+        queued_steps = 0;
+        junction_stair = 0;
+        snapshot_lock.writeEnd();
+
         if (ramp_stair > 0)
         {
             // Commit the partial block so the deceleration ramp starts from the exact current
             // position and with a clean `multi_steps_made` counter.
+            snapshot_lock.writeBegin();
             pos += multi_steps_made * static_cast<int32_t>(cur_dir);
             multi_steps_made = 0;
+            snapshot_lock.writeEnd();
 
-            INTERRUPT::setCallback(decelerate_multistep_handler);
-            INTERRUPT::setInterval(RAMP::interval(ramp_stair));
+            enter(Phase::DECELERATE);
+            set_stair_interval(ramp_stair);
         }
         else
         {
@@ -683,17 +1475,7 @@ public:
      */
     static void moveTo(const float sps, const int32_t target, StepperCallback onComplete = StepperCallback())
     {
-        const int32_t position = getPosition();
-        const int64_t relative_steps = static_cast<int64_t>(target) - static_cast<int64_t>(position);
-
-        // Clamp to the largest signed distance the planner can safely store. `move()` later takes
-        // an absolute value of `spec.steps`, so `INT32_MIN` must be avoided.
-        const int32_t clamped_steps =
-            (relative_steps > static_cast<int64_t>(INT32_MAX)) ? INT32_MAX
-            : (relative_steps < -static_cast<int64_t>(INT32_MAX)) ? -INT32_MAX
-                                                                : static_cast<int32_t>(relative_steps);
-
-        move(MovementSpec(clamped_steps, RAMP::getIntervalForSpeed(sps), RAMP::maxAccelStairs(sps)), onComplete);
+        move_to(target, MovementSpec(0, RAMP::getIntervalForSpeed(sps), RAMP::maxAccelStairs(sps)), onComplete);
     }
 
     /**
@@ -706,68 +1488,512 @@ public:
     }
 
     /**
-     * @brief Plan or re-plan a move from the current execution state.
+     * @brief Integer counterpart of `move(float)`.
+     */
+    static void move(const FixedSpeed speed, StepperCallback onComplete = StepperCallback())
+    {
+        move(MovementSpec::distance(speed, INT32_MAX - 1), onComplete);
+    }
+
+    /**
+     * @brief Integer counterpart of `moveTime(float)`.
+     */
+    static void moveTime(const FixedSpeed speed, const uint32_t time_ms, StepperCallback onComplete = StepperCallback())
+    {
+        move(MovementSpec::time(speed, time_ms), onComplete);
+    }
+
+    /**
+     * @brief Integer counterpart of `moveTo(float)`. Only the magnitude of `speed` is used.
+     */
+    static void moveTo(const FixedSpeed speed, const int32_t target, StepperCallback onComplete = StepperCallback())
+    {
+        const uint32_t run_interval = RAMP::getIntervalForSpeed(speed);
+        move_to(target, MovementSpec(0, run_interval, RAMP::maxAccelStairsForInterval(run_interval)), onComplete);
+    }
+
+    /**
+     * @brief Integer counterpart of `moveBy(float)`.
+     */
+    static void moveBy(const FixedSpeed speed, const int32_t steps, StepperCallback onComplete = StepperCallback())
+    {
+        move(MovementSpec::distance(speed, steps), onComplete);
+    }
+
+    /**
+     * @brief Like `move(float)`, but the run phase keeps the exact average rate.
      *
-     * Calling this while a move is already active is supported. The function first commits any
-     * partially executed block into `pos`, clears the queued phases from the previous request, and
-     * then derives a new profile from the current ramp stair and the requested `MovementSpec`.
+     * Meant for long constant-speed moves such as sidereal tracking, see `MovementSpec::exact()`.
+     */
+    static void moveExact(const float sps, StepperCallback onComplete = StepperCallback())
+    {
+        move(MovementSpec::exact(sps, INT32_MAX - 1), onComplete);
+    }
+
+    /**
+     * @brief Integer counterpart of `moveExact(float)`.
+     */
+    static void moveExact(const FixedSpeed speed, StepperCallback onComplete = StepperCallback())
+    {
+        move(MovementSpec::exact(speed, INT32_MAX - 1), onComplete);
+    }
+
+    /**
+     * @brief `move(float)` on ramp profile `PROFILE` of a `RampSet`.
      *
-     * The planner distinguishes four cases:
-     * 1. the current speed is too high to hit the target directly, so it must pre-decelerate
-     * 2. the requested speed already matches the current stair, so it can continue directly
-     * 3. the requested speed is slower, so it pre-decelerates and then runs
-     * 4. the requested speed is faster, so it accelerates first and then runs
+     * Position, direction and the current speed carry over from the previous profile, so switching
+     * e.g. from tracking to slewing needs no `stop()` in between.
+     */
+    template <uint8_t PROFILE>
+    static void move(const float sps, StepperCallback onComplete = StepperCallback())
+    {
+        move(MovementSpec::template distance<PROFILE>(sps, INT32_MAX - 1), onComplete);
+    }
+
+    /**
+     * @brief `moveTo(float)` on ramp profile `PROFILE` of a `RampSet`.
+     */
+    template <uint8_t PROFILE>
+    static void moveTo(const float sps, const int32_t target, StepperCallback onComplete = StepperCallback())
+    {
+        using ProfileRamp = typename RAMP::template Profile<PROFILE>;
+        move_to(target, MovementSpec(0, ProfileRamp::getIntervalForSpeed(sps), ProfileRamp::maxAccelStairs(sps), 0, PROFILE),
+                onComplete);
+    }
+
+    /**
+     * @brief `moveBy(float)` on ramp profile `PROFILE` of a `RampSet`.
+     */
+    template <uint8_t PROFILE>
+    static void moveBy(const float sps, const int32_t steps, StepperCallback onComplete = StepperCallback())
+    {
+        move(MovementSpec::template distance<PROFILE>(sps, steps), onComplete);
+    }
+
+    /**
+     * @brief `moveExact(float)` on ramp profile `PROFILE` of a `RampSet`.
+     */
+    template <uint8_t PROFILE>
+    static void moveExact(const float sps, StepperCallback onComplete = StepperCallback())
+    {
+        move(MovementSpec::template exact<PROFILE>(sps, INT32_MAX - 1), onComplete);
+    }
+
+    /**
+     * @brief Ramp profile the stepper currently runs on. Always zero for a single ramp.
+     */
+    static uint8_t activeProfile()
+    {
+        return profile;
+    }
+
+    /**
+     * @brief Replace the active plan and any queued segments with a single new move.
+     *
+     * Calling this while a move is already active is supported. The new profile is derived from
+     * the current ramp stair by `planMove()` and swapped in by `commit()`, so the timer is only
+     * stopped for the duration of the commit and not while the profile is being computed. If the
+     * handlers keep moving on while it plans, the move is finally planned with interrupts disabled,
+     * see `settle()`. Callbacks may call it, the interrupt state is restored after every commit.
      */
     static void move(MovementSpec spec, StepperCallback onComplete = StepperCallback())
+    {
+        clear_queue();
+        settle(spec, onComplete, nullptr);
+    }
+
+    /**
+     * @brief Compute a move from the current state without modifying it.
+     *
+     * All planner arithmetic happens here, outside of any critical section and while the timer
+     * keeps running. The result only takes effect once it is passed to `commit()`.
+     */
+    static Plan planMove(MovementSpec spec, StepperCallback onComplete = StepperCallback())
     {
         PROFILE_MOVE_BEGIN();
 
-        // TODO: this should happen as early as possible (e.g. in moveBy)
-        INTERRUPT::stop();
+        const StateSnapshot state = stateSnapshot();
+        const Plan plan = make_plan(state.cur_dir, state.ramp_stair, state.profile, spec, onComplete);
 
-        if (cur_dir != 0)
+        PROFILE_MOVE_END();
+
+        return plan;
+    }
+
+    /**
+     * @brief `planMove()` toward the absolute position `target`, `spec.steps` is ignored.
+     *
+     * The plan remembers the position the target was converted at. `commit()` takes the steps made
+     * since then off its run, so the move ends on `target` no matter how long the plan waited.
+     */
+    static Plan planMoveTo(const int32_t target, const MovementSpec &spec, StepperCallback onComplete = StepperCallback())
+    {
+        PROFILE_MOVE_BEGIN();
+
+        const StateSnapshot state = stateSnapshot();
+        const int32_t position = position_of(state);
+        const MovementSpec to_target(
+            steps_between(position, target), spec.run_interval, spec.accel_stair, spec.run_fraction, spec.profile);
+
+        Plan plan = make_plan(state.cur_dir, state.ramp_stair, state.profile, to_target, onComplete);
+        plan.absolute = true;
+        plan.from_pos = position;
+
+        PROFILE_MOVE_END();
+
+        return plan;
+    }
+
+    /**
+     * @brief Swap a plan from `planMove()` into the running state.
+     *
+     * The commit only copies the precomputed values and reprograms the timer, so the time spent
+     * with interrupts disabled does not depend on the planning case. Queued segments are left
+     * untouched; use `move()` to replace them as well.
+     *
+     * @return `false` if the direction, ramp stair or ramp profile changed since the plan was
+     * computed, or if the run of a `planMoveTo()` plan can not absorb the steps made since. The
+     * plan is discarded in that case and has to be computed again.
+     */
+    static bool commit(const Plan &plan)
+    {
+        PROFILE_COMMIT_BEGIN();
+        const InterruptLock::State irq = InterruptLock::lock();
+
+        Plan rebased = plan;
+        if (plan.from_dir != cur_dir || plan.from_stair != ramp_stair || plan.from_profile != profile ||
+            (plan.absolute && !rebase(rebased)))
         {
-            pos += multi_steps_made * static_cast<int32_t>(cur_dir);
+            InterruptLock::unlock(irq);
+            PROFILE_COMMIT_END();
+            return false;
         }
 
-        // reset values describing state of previous movement
-        run_interval = 0;
-        pre_decel_stairs_left = 0;
-        accel_stairs_left = 0;
-        run_steps_left = 0;
-        run_full_blocks_left = 0;
-        run_rest_block_steps = 0;
-        multi_steps_made = 0;
+        const bool running = apply(rebased);
 
-        cb_complete = onComplete;
+        InterruptLock::unlock(irq);
+        PROFILE_COMMIT_END();
+
+        if (!running)
+        {
+            terminate();
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Plan and commit a move on a `RampSet`, handing over between profiles if needed.
+     *
+     * If the requested profile can not run as fast as the axis currently moves, the active profile
+     * first decelerates to the highest stair the requested one can continue from. That deceleration
+     * is committed as its own plan and the requested move is queued behind it, so the regular
+     * junction handover switches the profile once the stair is reached.
+     *
+     * With a `target` the move ends on that absolute position, see `move_to()`.
+     *
+     * @return `false` if the state changed while planning, exactly like `commit()`.
+     */
+    static bool commit_handover(MovementSpec spec, StepperCallback onComplete, const int32_t *target = nullptr)
+    {
+        const StateSnapshot state = stateSnapshot();
+        const uint8_t from = state.profile;
+        const uint16_t stair = state.ramp_stair;
+        const uint16_t top = RAMP::topStair(spec.profile);
+
+        if (from == spec.profile || stair == 0 ||
+            (top > 0 && interval_of(from, stair) >= interval_of(spec.profile, top)))
+        {
+            return commit((target != nullptr) ? planMoveTo(*target, spec, onComplete) : planMove(spec, onComplete));
+        }
+
+        const int32_t from_pos = position_of(state);
+        const int32_t steps = (target != nullptr) ? steps_between(from_pos, *target) : spec.steps;
+
+        const uint16_t junction = (top > 0) ? RAMP::stairForInterval(from, interval_of(spec.profile, top)) : 0;
+        const int8_t dir = state.cur_dir;
+        const int32_t stop_steps = static_cast<int32_t>(stair) * static_cast<int32_t>(steps_per_stair_of(from));
+
+        const Plan plan = make_plan(
+            dir,
+            stair,
+            from,
+            MovementSpec(dir * stop_steps, interval_of(from, junction), junction, 0, from),
+            StepperCallback());
+
+        // the deceleration covers everything above the junction, the queued move the rest
+        const int64_t decel_steps =
+            static_cast<int64_t>(stair - junction) * static_cast<int64_t>(steps_per_stair_of(from));
+        int64_t follow_steps = static_cast<int64_t>(steps) - (dir * decel_steps);
+
+        const InterruptLock::State irq = InterruptLock::lock();
+
+        if (plan.from_dir != cur_dir || plan.from_stair != ramp_stair || plan.from_profile != profile)
+        {
+            InterruptLock::unlock(irq);
+            return false;
+        }
+
+        if (target != nullptr)
+        {
+            // the steps made while planning are already behind the target
+            follow_steps -= static_cast<int64_t>(pos + (static_cast<int32_t>(multi_steps_made) * cur_dir)) - from_pos;
+        }
+        const int32_t clamped_steps =
+            (follow_steps > static_cast<int64_t>(INT32_MAX)) ? INT32_MAX
+            : (follow_steps < -static_cast<int64_t>(INT32_MAX)) ? -INT32_MAX
+                                                              : static_cast<int32_t>(follow_steps);
+
+        snapshot_lock.writeBegin();
+        segments.push(QueuedSegment{clamped_steps, spec.run_interval, spec.run_fraction, spec.accel_stair, spec.profile, 0, onComplete});
+        queued_steps = static_cast<uint32_t>((clamped_steps >= 0) ? clamped_steps : -clamped_steps);
+        junction_stair = junction;
+
+        apply(plan);
+        snapshot_lock.writeEnd();
+
+        InterruptLock::unlock(irq);
+
+        return true;
+    }
+
+    /**
+     * @brief Append a segment to the lookahead queue.
+     *
+     * Queued segments are executed back to back. Consecutive segments in the same direction keep
+     * the highest junction stair that both segments allow and from which the remainder of the
+     * queue can still stop, instead of decelerating to zero at every boundary. Each segment's
+     * callback is invoked once its boundary has been reached.
+     *
+     * Junctions are fixed when a segment starts, so the active segment only blends into segments
+     * that were already queued at that time. Segments appended while a move is running start
+     * automatically once it completes; use `startQueue()` to start from idle.
+     *
+     * @return `false` if the queue is full or the segment has no steps, `true` otherwise.
+     */
+    static bool enqueue(MovementSpec spec, StepperCallback onComplete = StepperCallback())
+    {
+        if (spec.steps == 0)
+        {
+            return false;
+        }
+
+        const uint32_t abs_steps = static_cast<uint32_t>((spec.steps >= 0) ? spec.steps : -spec.steps);
+
+        const InterruptLock::State irq = InterruptLock::lock();
+
+        if (segments.full())
+        {
+            InterruptLock::unlock(irq);
+            return false;
+        }
+
+        segments.push(QueuedSegment{spec.steps, spec.run_interval, spec.run_fraction, spec.accel_stair, spec.profile, 0, onComplete});
+        snapshot_lock.writeBegin();
+        queued_steps += abs_steps;
+        snapshot_lock.writeEnd();
 
-        // `ramp_stair * STEPS_PER_STAIR` is the distance needed to unwind the currently active
+        // Backward pass: the new tail must stop at zero, which may lower the junction limits of the
+        // segments queued before it. Limits only ever grow while the queue grows, so the pass can
+        // stop at the first segment whose limit did not change.
+        for (size_t i = segments.size() - 1; i > 0; --i)
+        {
+            QueuedSegment &prev = segments[i - 1];
+            const QueuedSegment &next = segments[i];
+
+            uint16_t limit = 0;
+            // segments on different ramp profiles always meet at standstill
+            if ((prev.steps > 0) == (next.steps > 0) && prev.profile == next.profile)
+            {
+                limit = (prev.accel_stair < next.accel_stair) ? prev.accel_stair : next.accel_stair;
+
+                const uint32_t next_abs_steps =
+                    static_cast<uint32_t>((next.steps >= 0) ? next.steps : -next.steps);
+                const uint32_t stoppable =
+                    static_cast<uint32_t>(next.exit_stair) + (next_abs_steps / static_cast<uint32_t>(steps_per_stair_of(next.profile)));
+
+                if (stoppable < limit)
+                {
+                    limit = static_cast<uint16_t>(stoppable);
+                }
+            }
+
+            if (limit == prev.exit_stair)
+            {
+                break;
+            }
+
+            prev.exit_stair = limit;
+        }
+
+        InterruptLock::unlock(irq);
+
+        return true;
+    }
+
+    /**
+     * @brief Start executing the lookahead queue if the stepper is currently idle.
+     */
+    static void startQueue()
+    {
+        const InterruptLock::State irq = InterruptLock::lock();
+        const bool start = (cur_dir == 0) && !segments.empty();
+        InterruptLock::unlock(irq);
+
+        if (start)
+        {
+            start_next_segment();
+        }
+    }
+
+    /**
+     * @brief Return the number of segments waiting behind the active one.
+     */
+    static size_t queuedSegments()
+    {
+        const InterruptLock::State irq = InterruptLock::lock();
+        const size_t count = segments.size();
+        InterruptLock::unlock(irq);
+
+        return count;
+    }
+
+private:
+    /**
+     * @brief Drop the queued segments before `move()` replaces them.
+     */
+    static void clear_queue()
+    {
+        const InterruptLock::State irq = InterruptLock::lock();
+        snapshot_lock.writeBegin();
+        segments.clear();
+        queued_steps = 0;
+        junction_stair = 0;
+        snapshot_lock.writeEnd();
+        InterruptLock::unlock(irq);
+    }
+
+    /**
+     * @brief `move()` toward the absolute position `target`, `spec.steps` is ignored.
+     *
+     * The target is converted into steps from the same snapshot the plan is computed from, and the
+     * steps made between planning and commit are taken off the plan, see `planMoveTo()`. The motor
+     * keeps stepping while the plan is computed, so converting the target up front would overshoot
+     * it by those steps.
+     */
+    static void move_to(const int32_t target, MovementSpec spec, StepperCallback onComplete)
+    {
+        clear_queue();
+        settle(spec, onComplete, &target);
+    }
+
+    /// Plans derived while the interrupts keep running before `settle()` plans with them disabled.
+    constexpr static uint8_t COMMIT_ATTEMPTS = 4;
+
+    /**
+     * @brief Plan and commit a move, toward the absolute position `target` if one is given.
+     *
+     * A plan is rejected whenever the handlers advanced a stair while it was computed, which can
+     * happen on every attempt during a fast acceleration with short stairs. After
+     * `COMMIT_ATTEMPTS` rejected plans the move is planned with interrupts disabled, where the
+     * state can not change and the commit always succeeds. The handlers then wait for one planning
+     * pass instead of the main loop waiting for an opening that may never come.
+     */
+    static void settle(const MovementSpec &spec, StepperCallback onComplete, const int32_t *target)
+    {
+        for (uint8_t attempt = 0; attempt < COMMIT_ATTEMPTS; attempt++)
+        {
+            if (try_commit(spec, onComplete, target))
+            {
+                return;
+            }
+        }
+
+        const InterruptLock::State irq = InterruptLock::lock();
+        try_commit(spec, onComplete, target);
+        InterruptLock::unlock(irq);
+    }
+
+    /**
+     * @brief One planning pass of `settle()`.
+     *
+     * @return `false` if the state changed while planning, like `commit()`.
+     */
+    static bool try_commit(const MovementSpec &spec, StepperCallback onComplete, const int32_t *target)
+    {
+        if constexpr (RAMP_SET)
+        {
+            return commit_handover(spec, onComplete, target);
+        }
+        else
+        {
+            return commit((target != nullptr) ? planMoveTo(*target, spec, onComplete) : planMove(spec, onComplete));
+        }
+    }
+
+    /**
+     * @brief Derive a move from the given direction and ramp stair.
+     *
+     * This is pure arithmetic on its arguments and does not touch the volatile planner state, so
+     * it can run in the main loop while the interrupt handlers keep stepping. The resulting plan
+     * restarts the current stair from its first step, which is why only the direction and the
+     * stair matter and the progress inside the stair does not. A move on another ramp profile
+     * continues from the matching stair of that profile, see `handover_stair()`.
+     *
+     * The planner distinguishes four cases:
+     * 1. the current speed is too high to hit the target directly, so it must pre-decelerate
+     * 2. the requested speed already matches the current stair, so it can continue directly
+     * 3. the requested speed is slower, so it pre-decelerates and then runs
+     * 4. the requested speed is faster, so it accelerates first and then runs
+     */
+    static Plan make_plan(
+        const int8_t dir,
+        const uint16_t from_stair,
+        const uint8_t from_profile,
+        MovementSpec spec,
+        StepperCallback onComplete)
+    {
+        // Everything below is counted in stairs of the requested profile.
+        const uint16_t stair = handover_stair(from_profile, from_stair, spec.profile);
+        const uint8_t stair_steps = steps_per_stair_of(spec.profile);
+
+        Plan plan = {};
+        plan.from_dir = dir;
+        plan.from_stair = from_stair;
+        plan.from_profile = from_profile;
+        plan.profile = spec.profile;
+        plan.run_dir = dir;
+        plan.ramp_stair = stair;
+        plan.run_fraction = spec.run_fraction;
+        plan.on_complete = onComplete;
+
+        // `stair * STEPS_PER_STAIR` is the distance needed to unwind the currently active
         // deceleration ramp back to rest. The signed version expresses that same distance in the
         // direction the motor is currently moving.
         const auto abs_stop_steps_needed =
-            static_cast<int32_t>(ramp_stair) * static_cast<int32_t>(RAMP::STEPS_PER_STAIR);
-        const auto stop_steps_needed = abs_stop_steps_needed * cur_dir;
+            static_cast<int32_t>(stair) * static_cast<int32_t>(stair_steps);
+        const auto stop_steps_needed = abs_stop_steps_needed * dir;
 
         // movement target can't be reached even by stopping/decelerating
         // need correction or revert of the direction
-        if ((cur_dir * spec.steps) < (cur_dir * stop_steps_needed) && ramp_stair > 0)
+        if ((dir * spec.steps) < (dir * stop_steps_needed) && stair > 0)
         {
-            run_dir = -cur_dir;
+            plan.run_dir = static_cast<int8_t>(-dir);
 
-            pre_decel_stairs_left = ramp_stair;
+            plan.pre_decel_stairs_left = stair;
 
             // The requested relative target lies before the point where the current motion could
             // stop. The planner therefore spends `stop_steps_needed` reaching zero speed and then
             // covers the remaining distance in the opposite direction.
             uint32_t steps = abs(stop_steps_needed - spec.steps);
 
-            uint32_t accel_steps = spec.accel_stair * static_cast<uint32_t>(RAMP::STEPS_PER_STAIR);
+            uint32_t accel_steps = spec.accel_stair * static_cast<uint32_t>(stair_steps);
             uint32_t accel_decel_steps = accel_steps * 2;
 
             // reversed movement needs acceleration
             if (spec.accel_stair > 0)
             {
-                uint32_t stairs_possible = steps / RAMP::STEPS_PER_STAIR;
+                uint32_t stairs_possible = steps / stair_steps;
                 uint32_t max_stair_possible = stairs_possible / 2;
 
                 // no full ramp possible
@@ -775,203 +2001,333 @@ public:
                 {
                     // Only a triangular profile fits after the direction change. The planner picks
                     // the highest reachable stair and leaves any odd remainder as the center run.
-                    accel_stairs_left = max_stair_possible;
-                    run_rest_block_steps = steps - (max_stair_possible * (RAMP::STEPS_PER_STAIR * 2));
-                    run_interval = RAMP::interval(accel_stairs_left);
+                    plan.accel_stairs_left = max_stair_possible;
+                    plan.run_rest_block_steps = steps - (max_stair_possible * (stair_steps * 2));
+                    plan.run_interval = interval_of(spec.profile, plan.accel_stairs_left);
+                    plan.run_fraction = 0;
                 }
                 // full ramp possible
                 else
                 {
-                    accel_stairs_left = spec.accel_stair;
+                    plan.accel_stairs_left = spec.accel_stair;
 
                     // Reserve the symmetric acceleration and deceleration ramps first. Whatever is
                     // left becomes the constant-speed run segment.
                     const auto abs_run_steps = static_cast<uint32_t>(steps - accel_decel_steps);
 
                     // will evaluate to 0 for run_steps < RUN_BLOCK_SIZE
-                    run_full_blocks_left = abs_run_steps / RUN_BLOCK_SIZE;
+                    plan.run_full_blocks_left = abs_run_steps / RUN_BLOCK_SIZE;
                     // will evaluate to 0 for run_steps == n * RUN_BLOCK_SIZE
-                    run_rest_block_steps = static_cast<uint8_t>(abs_run_steps % RUN_BLOCK_SIZE);
+                    plan.run_rest_block_steps = static_cast<uint8_t>(abs_run_steps % RUN_BLOCK_SIZE);
 
-                    run_interval = spec.run_interval;
+                    plan.run_interval = spec.run_interval;
                     // TODO
                 }
             }
             // reversed movement slow, run does not need acceleration, but reverse movement does
             else
             {
-                run_steps_left = steps;
-                run_interval = spec.run_interval;
+                plan.run_steps_left = steps;
+                plan.run_interval = spec.run_interval;
             }
 
-            INTERRUPT::setCallback(pre_decelerate_multistep_handler);
-            INTERRUPT::setInterval(RAMP::interval(ramp_stair));
+            plan.phase = Phase::PRE_DECELERATE;
+            plan.interval = interval_of(spec.profile, stair);
         }
         // requested 0 steps and we can stop immediately
         else if (spec.steps == 0)
         {
             // no steps to go, and we don't have to decelerate -> terminate
-            terminate();
+            plan.phase = Phase::IDLE;
         }
         // requested speed is similar (on same acceleration ramp stair) as we already are, run directly
-        else if (spec.accel_stair == ramp_stair)
+        else if (spec.accel_stair == stair)
         {
             // The current stair already matches the requested speed, so only the constant-speed run
             // segment has to be planned. The reserved stop distance will be spent later by the final
             // deceleration ramp.
             const auto abs_run_steps = static_cast<uint32_t>(abs(spec.steps) - abs_stop_steps_needed);
 
-            if (cur_dir == 0 || ramp_stair == 0)
+            plan.run_interval = spec.run_interval;
+
+            if (dir == 0 || stair == 0)
             {
-                if (spec.steps > 0)
-                {
-                    cur_dir = 1;
-                    run_dir = 1;
-                    DRIVER::dir(true);
-                }
-                else
-                {
-                    cur_dir = -1;
-                    run_dir = -1;
-                    DRIVER::dir(false);
-                }
+                plan.set_dir = true;
+                plan.run_dir = (spec.steps > 0) ? 1 : -1;
             }
 
             // run directly (slow)
-            if (ramp_stair == 0)
+            if (stair == 0)
             {
-                run_steps_left = abs_run_steps;
+                plan.run_steps_left = abs_run_steps;
 
-                INTERRUPT::setCallback(run_slow_handler);
-                INTERRUPT::setInterval(spec.run_interval);
+                plan.phase = Phase::RUN_SLOW;
+                plan.interval = spec.run_interval;
             }
             // run directly (fast)
             else
             {
                 // will evaluate to 0 for run_steps < RUN_BLOCK_SIZE
-                run_full_blocks_left = abs_run_steps / RUN_BLOCK_SIZE;
+                plan.run_full_blocks_left = abs_run_steps / RUN_BLOCK_SIZE;
                 // will evaluate to 0 for run_steps == n * RUN_BLOCK_SIZE
-                run_rest_block_steps = static_cast<uint8_t>(abs_run_steps % RUN_BLOCK_SIZE);
+                plan.run_rest_block_steps = static_cast<uint8_t>(abs_run_steps % RUN_BLOCK_SIZE);
 
-                if (run_full_blocks_left > 0)
+                if (plan.run_full_blocks_left > 0)
                 {
-                    INTERRUPT::setCallback(run_full_multistep_handler);
+                    plan.phase = Phase::RUN_FULL;
                 }
-                else if (run_rest_block_steps > 0)
+                else if (plan.run_rest_block_steps > 0)
                 {
-                    INTERRUPT::setCallback(run_rest_multistep_handler);
+                    plan.phase = Phase::RUN_REST;
                 }
                 else
                 {
-                    INTERRUPT::setCallback(decelerate_multistep_handler);
+                    plan.phase = Phase::DECELERATE;
                 }
-                INTERRUPT::setInterval(spec.run_interval);
+                plan.interval = spec.run_interval;
             }
         }
         // requested speed is slower (lower acceleration ramp stair), need to pre-decelerate first then run
-        else if (spec.accel_stair < ramp_stair)
+        else if (spec.accel_stair < stair)
         {
-            run_interval = spec.run_interval;
+            plan.run_interval = spec.run_interval;
 
-            // The move must first descend from the current stair to the requested stair. Those
-            // deceleration steps are reserved up front; the rest becomes the run segment.
+            // The move must first descend from the current stair to the requested stair and later
+            // unwind the requested stair back to zero. Together those ramps cover exactly the
+            // current stop distance; the rest becomes the run segment.
             // pre-decelerate, then run (calculate ramp without accel)
-            pre_decel_stairs_left = ramp_stair - spec.accel_stair;
-            const uint32_t pre_decel_steps = pre_decel_stairs_left * static_cast<uint32_t>(RAMP::STEPS_PER_STAIR);
-            const uint32_t abs_run_steps = abs(spec.steps) - pre_decel_steps;
+            plan.pre_decel_stairs_left = stair - spec.accel_stair;
+            const uint32_t abs_run_steps = abs(spec.steps) - static_cast<uint32_t>(abs_stop_steps_needed);
 
             if (spec.accel_stair == 0)
             {
-                run_steps_left = abs_run_steps;
+                plan.run_steps_left = abs_run_steps;
             }
             else
             {
                 // perform multi steps in run phase
                 // will evaluate to 0 for run_steps < RUN_BLOCK_SIZE
-                run_full_blocks_left = abs_run_steps / RUN_BLOCK_SIZE;
+                plan.run_full_blocks_left = abs_run_steps / RUN_BLOCK_SIZE;
                 // will evaluate to 0 for run_steps == n * RUN_BLOCK_SIZE
-                run_rest_block_steps = static_cast<uint8_t>(abs_run_steps % RUN_BLOCK_SIZE);
+                plan.run_rest_block_steps = static_cast<uint8_t>(abs_run_steps % RUN_BLOCK_SIZE);
             }
 
-            INTERRUPT::setCallback(pre_decelerate_multistep_handler);
-            INTERRUPT::setInterval(RAMP::interval(ramp_stair));
+            plan.phase = Phase::PRE_DECELERATE;
+            plan.interval = interval_of(spec.profile, stair);
         }
         // requested speed is faster (higher acceleration ramp stair), need to accelerate first then run
         else
         {
-            if (spec.steps > 0)
-            {
-                run_dir = 1;
-                cur_dir = 1;
-                DRIVER::dir(true);
-            }
-            else
-            {
-                run_dir = -1;
-                cur_dir = -1;
-                DRIVER::dir(false);
-            }
+            plan.set_dir = true;
+            plan.run_dir = (spec.steps > 0) ? 1 : -1;
 
             // The planner now chooses the highest reachable stair for this move. If the requested
             // peak stair does not fit into the available distance, it falls back to the highest
             // triangular profile that does fit.
 
-            const auto required_accel_stairs = spec.accel_stair - ramp_stair;
+            const auto required_accel_stairs = spec.accel_stair - stair;
 
             const auto req_accel_steps =
-                static_cast<uint32_t>(required_accel_stairs) * static_cast<uint32_t>(RAMP::STEPS_PER_STAIR);
+                static_cast<uint32_t>(required_accel_stairs) * static_cast<uint32_t>(stair_steps);
             const auto req_decel_steps =
-                static_cast<uint32_t>(spec.accel_stair) * static_cast<uint32_t>(RAMP::STEPS_PER_STAIR);
+                static_cast<uint32_t>(spec.accel_stair) * static_cast<uint32_t>(stair_steps);
             const auto req_accel_decel_steps = req_accel_steps + req_decel_steps;
             const uint32_t abs_steps = (spec.steps >= 0) ? spec.steps : -spec.steps;
 
             // full ramp not possible
             if (abs_steps <= req_accel_decel_steps)
             {
-                // We are already at `ramp_stair`, so only the still-missing acceleration stairs can
-                // be added before a symmetric deceleration has to begin.
+                // We are already at `stair`, so only the still-missing acceleration stairs can be
+                // added before a symmetric deceleration has to begin.
                 const uint32_t accel_steps_made =
-                    static_cast<uint32_t>(ramp_stair) * static_cast<uint32_t>(RAMP::STEPS_PER_STAIR);
-                accel_stairs_left = static_cast<uint16_t>((abs_steps - accel_steps_made) /
-                                                          (static_cast<uint32_t>(RAMP::STEPS_PER_STAIR) * 2U));
+                    static_cast<uint32_t>(stair) * static_cast<uint32_t>(stair_steps);
+                plan.accel_stairs_left = static_cast<uint16_t>((abs_steps - accel_steps_made) /
+                                                               (static_cast<uint32_t>(stair_steps) * 2U));
+
+                // the peak stair is below the requested speed, so there is no fraction to carry
+                plan.run_fraction = 0;
 
-                if (ramp_stair > 0 || accel_stairs_left > 0)
+                if (stair > 0 || plan.accel_stairs_left > 0)
                 {
-                    run_interval = RAMP::interval(ramp_stair + accel_stairs_left);
+                    plan.run_interval = interval_of(spec.profile, stair + plan.accel_stairs_left);
                 }
                 else
                 {
-                    run_steps_left = abs_steps;
+                    plan.run_steps_left = abs_steps;
 
-                    INTERRUPT::setCallback(run_slow_handler);
-                    INTERRUPT::setInterval(RAMP::interval(1));
+                    plan.phase = Phase::RUN_SLOW;
+                    plan.interval = interval_of(spec.profile, 1);
 
-                    PROFILE_MOVE_END();
-                    return;
+                    return plan;
                 }
             }
             // full ramp
             else
             {
-                accel_stairs_left = required_accel_stairs;
-                run_interval = spec.run_interval;
+                plan.accel_stairs_left = required_accel_stairs;
+                plan.run_interval = spec.run_interval;
             }
 
             // After reserving both ramp halves around the chosen peak stair, the remaining distance
-            // becomes the constant-speed run segment.
-            const uint32_t abs_run_steps = abs_steps - ((ramp_stair + accel_stairs_left) * RAMP::STEPS_PER_STAIR * 2);
+            // becomes the constant-speed run segment. The acceleration half only climbs from the
+            // current stair, while the deceleration half unwinds the whole peak back to zero.
+            const uint32_t abs_run_steps =
+                abs_steps - ((static_cast<uint32_t>(stair) + (2U * plan.accel_stairs_left)) * stair_steps);
 
             // perform multi steps in run phase
             // will evaluate to 0 for run_steps < RUN_BLOCK_SIZE
-            run_full_blocks_left = abs_run_steps / RUN_BLOCK_SIZE;
+            plan.run_full_blocks_left = abs_run_steps / RUN_BLOCK_SIZE;
             // will evaluate to 0 for run_steps == n * RUN_BLOCK_SIZE
-            run_rest_block_steps = static_cast<uint8_t>(abs_run_steps % RUN_BLOCK_SIZE);
+            plan.run_rest_block_steps = static_cast<uint8_t>(abs_run_steps % RUN_BLOCK_SIZE);
 
-            INTERRUPT::setCallback(accelerate_multistep_handler);
-            INTERRUPT::setInterval(RAMP::interval(++ramp_stair));
+            // The current stair may already be the highest one that still fits into a short move,
+            // in which case the run phase starts right away.
+            if (plan.accel_stairs_left == 0)
+            {
+                if (plan.run_full_blocks_left > 0)
+                {
+                    plan.phase = Phase::RUN_FULL;
+                }
+                else if (plan.run_rest_block_steps > 0)
+                {
+                    plan.phase = Phase::RUN_REST;
+                }
+                else
+                {
+                    plan.phase = Phase::DECELERATE;
+                }
+                plan.interval = plan.run_interval;
+            }
+            else
+            {
+                plan.ramp_stair = stair + 1;
+                plan.interval = interval_of(spec.profile, plan.ramp_stair);
+                plan.phase = Phase::ACCELERATE;
+            }
         }
 
-        PROFILE_MOVE_END();
+        return plan;
+    }
+
+    /**
+     * @brief Take the steps made since `plan` converted its target off its run.
+     *
+     * Must be called with interrupts disabled. The handlers stay on the stair the plan starts from,
+     * so every step made since planning went in `from_dir`: a plan that keeps the direction has
+     * that many steps less to run, a reversal has to come back that many more. The run phases the
+     * plan enters are kept as they are.
+     *
+     * @return `false` if the run can not absorb the steps and the plan has to be computed again.
+     */
+    static bool rebase(Plan &plan)
+    {
+        const int32_t position = pos + (static_cast<int32_t>(multi_steps_made) * static_cast<int32_t>(cur_dir));
+        const int64_t moved = (static_cast<int64_t>(position) - plan.from_pos) * plan.from_dir;
+
+        if (moved == 0)
+        {
+            return true;
+        }
+        if (moved < 0 || plan.phase == Phase::IDLE)
+        {
+            return false;
+        }
+
+        const int64_t change = (plan.run_dir == plan.from_dir) ? -moved : moved;
+
+        if (plan.run_steps_left > 0)
+        {
+            const int64_t steps = static_cast<int64_t>(plan.run_steps_left) + change;
+            if (steps <= 0 || steps > static_cast<int64_t>(UINT32_MAX))
+            {
+                return false;
+            }
+            plan.run_steps_left = static_cast<uint32_t>(steps);
+            return true;
+        }
+
+        const int64_t steps = (static_cast<int64_t>(plan.run_full_blocks_left) * RUN_BLOCK_SIZE) +
+                              plan.run_rest_block_steps + change;
+
+        // a run that starts with full blocks must keep one, a run of rest steps stays one
+        if (plan.run_full_blocks_left == 0)
+        {
+            if (plan.run_rest_block_steps == 0 || steps <= 0 || steps > UINT8_MAX)
+            {
+                return false;
+            }
+            plan.run_rest_block_steps = static_cast<uint8_t>(steps);
+            return true;
+        }
+
+        if (steps < RUN_BLOCK_SIZE || steps / RUN_BLOCK_SIZE > static_cast<int64_t>(UINT32_MAX))
+        {
+            return false;
+        }
+        plan.run_full_blocks_left = static_cast<uint32_t>(steps / RUN_BLOCK_SIZE);
+        plan.run_rest_block_steps = static_cast<uint8_t>(steps % RUN_BLOCK_SIZE);
+        return true;
+    }
+
+    /**
+     * @brief Swap a plan into the volatile planner state without any locking.
+     *
+     * The partially executed stair or block is committed into `pos` first, because the new plan
+     * restarts it from its first step. Queue bookkeeping is left untouched, so
+     * `start_next_segment()` can apply a plan with its junction stair already selected.
+     *
+     * @return `false` if the plan ends the move right away and the caller still has to
+     * `terminate()`, `true` otherwise.
+     */
+    static bool apply(const Plan &plan)
+    {
+        INTERRUPT::stop();
+
+        snapshot_lock.writeBegin();
+
+        if (cur_dir != 0)
+        {
+            pos += multi_steps_made * static_cast<int32_t>(cur_dir);
+        }
+        multi_steps_made = 0;
+
+        cb_complete = plan.on_complete;
+
+        if (plan.phase == Phase::IDLE)
+        {
+            snapshot_lock.writeEnd();
+            return false;
+        }
+
+        run_dir = plan.run_dir;
+        if (plan.set_dir)
+        {
+            if (cur_dir == 0)
+            {
+                report_move(true);
+            }
+            cur_dir = plan.run_dir;
+            DRIVER::dir(cur_dir > 0);
+        }
+
+        ramp_stair = plan.ramp_stair;
+        profile = plan.profile;
+        run_interval = plan.run_interval;
+        run_fraction = plan.run_fraction;
+        run_phase = 0;
+        run_stretched = false;
+        pre_decel_stairs_left = plan.pre_decel_stairs_left;
+        accel_stairs_left = plan.accel_stairs_left;
+        run_steps_left = plan.run_steps_left;
+        run_full_blocks_left = plan.run_full_blocks_left;
+        run_rest_block_steps = plan.run_rest_block_steps;
+
+        snapshot_lock.writeEnd();
+
+        enter(plan.phase);
+        set_step_interval(plan.interval, plan.phase != Phase::RUN_SLOW && plan.phase != Phase::RUN_REST);
+
+        return true;
     }
 };
 
@@ -987,12 +2343,27 @@ int8_t volatile Stepper<INTERRUPT, DRIVER, RAMP>::cur_dir = 0;
 template <typename INTERRUPT, typename DRIVER, typename RAMP>
 uint16_t volatile Stepper<INTERRUPT, DRIVER, RAMP>::ramp_stair = 0;
 
+template <typename INTERRUPT, typename DRIVER, typename RAMP>
+uint8_t volatile Stepper<INTERRUPT, DRIVER, RAMP>::profile = 0;
+
 template <typename INTERRUPT, typename DRIVER, typename RAMP>
 uint32_t volatile Stepper<INTERRUPT, DRIVER, RAMP>::run_interval = 0;
 
+template <typename INTERRUPT, typename DRIVER, typename RAMP>
+uint16_t volatile Stepper<INTERRUPT, DRIVER, RAMP>::run_fraction = 0;
+
+template <typename INTERRUPT, typename DRIVER, typename RAMP>
+uint16_t volatile Stepper<INTERRUPT, DRIVER, RAMP>::run_phase = 0;
+
+template <typename INTERRUPT, typename DRIVER, typename RAMP>
+bool volatile Stepper<INTERRUPT, DRIVER, RAMP>::run_stretched = false;
+
 template <typename INTERRUPT, typename DRIVER, typename RAMP>
 StepperCallback Stepper<INTERRUPT, DRIVER, RAMP>::cb_complete = StepperCallback();
 
+template <typename INTERRUPT, typename DRIVER, typename RAMP>
+SeqLock Stepper<INTERRUPT, DRIVER, RAMP>::snapshot_lock;
+
 template <typename INTERRUPT, typename DRIVER, typename RAMP>
 uint16_t volatile Stepper<INTERRUPT, DRIVER, RAMP>::pre_decel_stairs_left = 0;
 
@@ -1009,4 +2380,25 @@ template <typename INTERRUPT, typename DRIVER, typename RAMP>
 uint8_t volatile Stepper<INTERRUPT, DRIVER, RAMP>::run_rest_block_steps = 0;
 
 template <typename INTERRUPT, typename DRIVER, typename RAMP>
-uint8_t volatile Stepper<INTERRUPT, DRIVER, RAMP>::multi_steps_made = 0;
\ No newline at end of file
+uint8_t volatile Stepper<INTERRUPT, DRIVER, RAMP>::multi_steps_made = 0;
+template <typename INTERRUPT, typename DRIVER, typename RAMP>
+uint16_t volatile Stepper<INTERRUPT, DRIVER, RAMP>::junction_stair = 0;
+
+template <typename INTERRUPT, typename DRIVER, typename RAMP>
+uint8_t volatile Stepper<INTERRUPT, DRIVER, RAMP>::burst = 1;
+
+template <typename INTERRUPT, typename DRIVER, typename RAMP>
+uint32_t volatile Stepper<INTERRUPT, DRIVER, RAMP>::burst_gap = 0;
+
+template <typename INTERRUPT, typename DRIVER, typename RAMP>
+uint32_t volatile Stepper<INTERRUPT, DRIVER, RAMP>::burst_tail = 0;
+
+template <typename INTERRUPT, typename DRIVER, typename RAMP>
+bool volatile Stepper<INTERRUPT, DRIVER, RAMP>::burst_rearm = false;
+
+template <typename INTERRUPT, typename DRIVER, typename RAMP>
+etl::circular_buffer<typename Stepper<INTERRUPT, DRIVER, RAMP>::QueuedSegment, STEPPER_QUEUE_SIZE>
+    Stepper<INTERRUPT, DRIVER, RAMP>::segments;
+
+template <typename INTERRUPT, typename DRIVER, typename RAMP>
+uint32_t volatile Stepper<INTERRUPT, DRIVER, RAMP>::queued_steps = 0;
@@ -0,0 +1,350 @@
+#pragma once
+
+#include <stdint.h> // NOLINT(modernize-deprecated-headers)
+
+#include "Stepper.h"
+
+/**
+ * @brief Per-axis Bresenham stepping of a `StepperGroup`, unrolled at compile time.
+ *
+ * Axis `I` is driven by `HEAD`, the following axes by `REST`.
+ */
+template <uint8_t I, typename HEAD, typename... REST>
+struct StepperGroupAxes
+{
+    template <typename U>
+    constexpr static bool is_deferred_pulse(decltype(U::DEFERRED_PULSE) *)
+    {
+        return U::DEFERRED_PULSE;
+    }
+
+    template <typename U>
+    constexpr static bool is_deferred_pulse(...)
+    {
+        return false;
+    }
+
+    static void init()
+    {
+        HEAD::init();
+        if constexpr (sizeof...(REST) > 0)
+        {
+            StepperGroupAxes<I + 1, REST...>::init();
+        }
+    }
+
+    /**
+     * @brief Advance every axis by its share of one dominant step.
+     *
+     * The dominant axis has `delta == major` and therefore steps every time. An axis whose driver
+     * defers its pulses is released on every dominant step, whether it steps again or not.
+     */
+    static inline __attribute__((always_inline)) void step(const uint32_t major, uint32_t *error, const uint32_t *delta)
+    {
+        if constexpr (is_deferred_pulse<HEAD>(nullptr))
+        {
+            HEAD::release();
+        }
+
+        error[I] += delta[I];
+        if (error[I] >= major)
+        {
+            error[I] -= major;
+            HEAD::step();
+        }
+
+        if constexpr (sizeof...(REST) > 0)
+        {
+            StepperGroupAxes<I + 1, REST...>::step(major, error, delta);
+        }
+    }
+
+    static inline __attribute__((always_inline)) void dir(const bool forward, const bool *reversed)
+    {
+        HEAD::dir(forward != reversed[I]);
+
+        if constexpr (sizeof...(REST) > 0)
+        {
+            StepperGroupAxes<I + 1, REST...>::dir(forward, reversed);
+        }
+    }
+};
+
+/**
+ * @brief Coordinated linear moves of several motors driven by a single timer.
+ *
+ * The group plans one ramp with a regular `Stepper` along a virtual axis whose length is the
+ * distance of the dominant axis, i.e. the axis with the most steps. Every timer callback of that
+ * stepper advances all axes through Bresenham error accumulation, so the dominant axis steps
+ * exactly like a single-axis `Stepper` and the other axes are spread evenly along the line.
+ *
+ * The error accumulators start at zero, which makes a minor axis step on the first dominant step at
+ * or after its exact share of the line. All axes therefore make their last step on the final
+ * dominant step. The cost per interrupt is one add and one compare per axis.
+ *
+ * Only one `INTERRUPT` is consumed no matter how many axes the group drives. Axis positions are
+ * derived from the progress of the virtual axis on request instead of being counted in the
+ * interrupt handler.
+ *
+ * @tparam INTERRUPT Timer backend shared by all axes.
+ * @tparam RAMP Ramp model applied to the dominant axis.
+ * @tparam DRIVERS Stepper output backends, one per axis, in axis index order.
+ */
+template <typename INTERRUPT, typename RAMP, typename... DRIVERS>
+class StepperGroup
+{
+    static_assert(sizeof...(DRIVERS) > 0, "A stepper group needs at least one axis");
+    static_assert(sizeof...(DRIVERS) <= UINT8_MAX, "A stepper group can drive at most 255 axes");
+
+public:
+    constexpr static uint8_t AXES = sizeof...(DRIVERS);
+
+    /**
+     * @brief Static class. We don't need constructor.
+     */
+    StepperGroup() = delete;
+
+private:
+    using Axes = StepperGroupAxes<0, DRIVERS...>;
+
+    /**
+     * @brief Driver of the virtual axis the lead stepper moves along.
+     */
+    struct LineDriver
+    {
+        static void init()
+        {
+            Axes::init();
+        }
+
+        static inline __attribute__((always_inline)) void step()
+        {
+            Axes::step(major, error, delta);
+        }
+
+        static inline __attribute__((always_inline)) void dir(const bool forward)
+        {
+            Axes::dir(forward, reversed);
+        }
+    };
+
+public:
+    /**
+     * @brief Stepper that plans and times the dominant axis.
+     */
+    using Lead = Stepper<INTERRUPT, LineDriver, RAMP>;
+
+private:
+    static int32_t origin[AXES]; ///< Axis positions at the start of the current line.
+    static uint32_t delta[AXES]; ///< Absolute distance of each axis along the current line.
+    static bool reversed[AXES]; ///< Whether an axis moves in negative direction along the line.
+    static uint32_t error[AXES]; ///< Bresenham accumulators, always below `major`.
+    static uint32_t major; ///< Distance of the dominant axis, i.e. the length of the line in steps.
+
+    /**
+     * @brief Set up a new line from the current positions and start it on the lead stepper.
+     */
+    template <typename SPEED>
+    static bool start(const SPEED speed, const int32_t (&steps)[AXES], StepperCallback onComplete)
+    {
+        if (Lead::isRunning())
+        {
+            return false;
+        }
+
+        int32_t positions[AXES];
+        for (uint8_t i = 0; i < AXES; i++)
+        {
+            positions[i] = getPosition(i);
+        }
+
+        uint32_t longest = 0;
+        for (uint8_t i = 0; i < AXES; i++)
+        {
+            origin[i] = positions[i];
+            reversed[i] = steps[i] < 0;
+            delta[i] = reversed[i] ? 0U - static_cast<uint32_t>(steps[i]) : static_cast<uint32_t>(steps[i]);
+            error[i] = 0;
+
+            if (delta[i] > longest)
+            {
+                longest = delta[i];
+            }
+        }
+        major = (longest > static_cast<uint32_t>(INT32_MAX - 1)) ? static_cast<uint32_t>(INT32_MAX - 1) : longest;
+
+        // The line always runs forward, the axis directions are carried by `reversed`.
+        const typename Lead::MovementSpec spec = Lead::MovementSpec::distance(speed, static_cast<int32_t>(major));
+        Lead::setPosition(0);
+        Lead::move(typename Lead::MovementSpec(static_cast<int32_t>(major), spec.run_interval, spec.accel_stair), onComplete);
+
+        return true;
+    }
+
+public:
+    /**
+     * @brief Initialize all drivers and the shared timer backend.
+     */
+    static void init()
+    {
+        Lead::init();
+    }
+
+    /**
+     * @brief Move all axes by the given signed step counts along a straight line.
+     *
+     * `sps` is the speed of the dominant axis. Only the magnitude is used, the direction of each
+     * axis comes from the sign of its step count.
+     *
+     * @return `false` if the group is still moving. Lines are only started from standstill.
+     */
+    static bool moveBy(const float sps, const int32_t (&steps)[AXES], StepperCallback onComplete = StepperCallback())
+    {
+        return start(sps, steps, onComplete);
+    }
+
+    /**
+     * @brief Integer counterpart of `moveBy(float)`.
+     */
+    static bool moveBy(const FixedSpeed speed, const int32_t (&steps)[AXES], StepperCallback onComplete = StepperCallback())
+    {
+        return start(speed, steps, onComplete);
+    }
+
+    /**
+     * @brief Move all axes to absolute targets along a straight line.
+     *
+     * @return `false` if the group is still moving. Lines are only started from standstill.
+     */
+    static bool moveTo(const float sps, const int32_t (&targets)[AXES], StepperCallback onComplete = StepperCallback())
+    {
+        int32_t steps[AXES];
+        for (uint8_t i = 0; i < AXES; i++)
+        {
+            steps[i] = targets[i] - getPosition(i);
+        }
+        return start(sps, steps, onComplete);
+    }
+
+    /**
+     * @brief Integer counterpart of `moveTo(float)`.
+     */
+    static bool moveTo(const FixedSpeed speed, const int32_t (&targets)[AXES], StepperCallback onComplete = StepperCallback())
+    {
+        int32_t steps[AXES];
+        for (uint8_t i = 0; i < AXES; i++)
+        {
+            steps[i] = targets[i] - getPosition(i);
+        }
+        return start(speed, steps, onComplete);
+    }
+
+    /**
+     * @brief Decelerate along the current line and stop.
+     *
+     * All axes keep following the line while the dominant axis decelerates.
+     */
+    static void stop()
+    {
+        Lead::stop();
+    }
+
+    /**
+     * @brief Request a controlled stop and replace the completion callback.
+     */
+    static void stop(StepperCallback onComplete)
+    {
+        Lead::stop(onComplete);
+    }
+
+    /**
+     * @brief Abort the current line immediately.
+     */
+    static void terminate(bool callCallback = true)
+    {
+        Lead::terminate(callCallback);
+    }
+
+    /**
+     * @brief Return whether the group is currently emitting steps.
+     */
+    static bool isRunning()
+    {
+        return Lead::isRunning();
+    }
+
+    /**
+     * @brief Return the number of dominant axis steps left on the current line.
+     */
+    static uint32_t distanceToGo()
+    {
+        return Lead::distanceToGo();
+    }
+
+    /**
+     * @brief Return the current position of `axis`.
+     *
+     * The position is the Bresenham count at the current progress of the line, computed in 64
+     * bits outside of the interrupt handler.
+     */
+    static int32_t getPosition(const uint8_t axis)
+    {
+        if (major == 0)
+        {
+            return origin[axis];
+        }
+
+        const auto progress = static_cast<uint32_t>(Lead::getPosition());
+        const auto steps =
+            static_cast<int32_t>(static_cast<uint64_t>(progress) * delta[axis] / major);
+
+        return reversed[axis] ? origin[axis] - steps : origin[axis] + steps;
+    }
+
+    /**
+     * @brief Override the positions of all axes. Only valid while the group is idle.
+     */
+    static void setPosition(const int32_t (&positions)[AXES])
+    {
+        for (uint8_t i = 0; i < AXES; i++)
+        {
+            origin[i] = positions[i];
+            delta[i] = 0;
+            error[i] = 0;
+        }
+        major = 0;
+        Lead::setPosition(0);
+    }
+
+    /**
+     * @brief Reset all positions and the lead stepper. Intended for use while idle.
+     */
+    static void reset()
+    {
+        Lead::reset();
+
+        for (uint8_t i = 0; i < AXES; i++)
+        {
+            origin[i] = 0;
+            delta[i] = 0;
+            reversed[i] = false;
+            error[i] = 0;
+        }
+        major = 0;
+    }
+};
+
+template <typename INTERRUPT, typename RAMP, typename... DRIVERS>
+int32_t StepperGroup<INTERRUPT, RAMP, DRIVERS...>::origin[AXES] = {};
+
+template <typename INTERRUPT, typename RAMP, typename... DRIVERS>
+uint32_t StepperGroup<INTERRUPT, RAMP, DRIVERS...>::delta[AXES] = {};
+
+template <typename INTERRUPT, typename RAMP, typename... DRIVERS>
+bool StepperGroup<INTERRUPT, RAMP, DRIVERS...>::reversed[AXES] = {};
+
+template <typename INTERRUPT, typename RAMP, typename... DRIVERS>
+uint32_t StepperGroup<INTERRUPT, RAMP, DRIVERS...>::error[AXES] = {};
+
+template <typename INTERRUPT, typename RAMP, typename... DRIVERS>
+uint32_t StepperGroup<INTERRUPT, RAMP, DRIVERS...>::major = 0;
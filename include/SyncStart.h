@@ -0,0 +1,66 @@
+#pragma once
+
+#ifndef noInterrupts
+#define noInterrupts() \
+    do                 \
+    {                  \
+    } while (0)
+#endif
+
+#ifndef interrupts
+#define interrupts() \
+    do               \
+    {                \
+    } while (0)
+#endif
+
+#include "IntervalInterrupt.h"
+
+/**
+ * @brief Start the moves of several steppers at the same time.
+ *
+ * Each `Stepper` starts its timer from `moveTo()`, so axes started one after another begin hundreds
+ * of cycles apart and their ramps stay offset for the whole move. Between `hold()` and `release()`
+ * the timers of `INTERRUPTS` are started halted, and `release()` lets them count together:
+ *
+ * ```cpp
+ * using launch = SyncStart<IntervalInterrupt<Timer::TIMER_3>, IntervalInterrupt<Timer::TIMER_4>>;
+ *
+ * launch::hold();
+ * ra::moveTo(speed_ra, target_ra);
+ * dec::moveTo(speed_dec, target_dec);
+ * launch::release();
+ * ```
+ *
+ * Timers that already run a move are not affected. On AVR every timer defers its clock select bits
+ * and on STM32 its counter enable, and `release()` sets them one after another with interrupts
+ * disabled, a fixed few cycles apart. Channels of one `CompareChannels` timer count their first
+ * intervals from the same tick of the shared counter.
+ *
+ * @tparam INTERRUPTS Timer backends of the steppers to start, each providing `hold()` and
+ * `release()`: `IntervalInterrupt` and `ChannelInterrupt`.
+ */
+template <typename... INTERRUPTS>
+class SyncStart
+{
+public:
+    SyncStart() = delete;
+
+    /**
+     * @brief Keep the timers that are started from now on halted.
+     */
+    static void hold()
+    {
+        (INTERRUPTS::hold(), ...);
+    }
+
+    /**
+     * @brief Let the timers started since `hold()` count together.
+     */
+    static void release()
+    {
+        noInterrupts();
+        (INTERRUPTS::release(), ...);
+        interrupts();
+    }
+};
@@ -0,0 +1,445 @@
+#pragma once
+
+#include <stdint.h> // NOLINT(modernize-deprecated-headers)
+
+#include "IntervalInterrupt.h"
+
+/**
+ * @brief Several virtual interval timers sharing one free-running hardware counter.
+ *
+ * Every channel behaves like an `IntervalInterrupt` in CTC mode: `setInterval()` defines the time
+ * between two callbacks and the next deadline is counted from the previous one, so a channel does
+ * not drift no matter how late its callback ran. The deadlines of all running channels are kept in
+ * an array ordered by due time, and the hardware compare is always armed for the earliest one.
+ *
+ * A hardware callback dispatches every channel that is due, in deadline order, and re-arms the
+ * compare afterwards. Channels whose deadlines collide are therefore served one after another:
+ * - The worst-case lateness of a callback is `(CHANNELS - 1) * (t_callback + t_dispatch)` plus the
+ *   interrupt latency, where `t_callback` is the longest callback of the other channels and
+ *   `t_dispatch` the multiplexer overhead per channel. Lateness does not accumulate, the following
+ *   deadline of a late channel still lies one interval after the missed one.
+ * - The aggregate rate of all channels is limited to `FREQ / (t_callback + t_dispatch)` callbacks
+ *   per second. Beyond that the dispatcher is permanently behind and every channel runs slow.
+ *
+ * Keeping the ordered array costs `O(CHANNELS)` per rescheduled channel, which stays cheaper than a
+ * heap for the handful of channels a single timer serves.
+ *
+ * Intervals are limited to `MAX_INTERVAL`, because deadlines are compared by their signed
+ * difference on the wrapping 32-bit counter.
+ *
+ * @tparam CLOCK Free-running counter backend. It must expose `FREQ`, `init()`, `now()`,
+ * `arm(deadline)`, `disarm()`, `lock()`, which disables interrupts and returns the previous state,
+ * and `unlock(state)`, which restores it, and call `handle()` once an armed deadline is reached.
+ * @tparam CHANNELS Number of virtual timers.
+ */
+template <typename CLOCK, uint8_t CHANNELS>
+class TimerMultiplexer
+{
+    static_assert(CHANNELS > 0, "A timer multiplexer needs at least one channel");
+
+public:
+    TimerMultiplexer() = delete;
+
+    constexpr static uint32_t FREQ = CLOCK::FREQ;
+
+    constexpr static uint32_t MAX_INTERVAL = static_cast<uint32_t>(INT32_MAX);
+
+private:
+    struct Channel
+    {
+        timer_callback callback;
+        uint32_t base; ///< Deadline the current interval is counted from.
+        uint32_t deadline; ///< Next due time on the `CLOCK` counter.
+        bool active;
+    };
+
+    static Channel channels[CHANNELS];
+    static uint8_t order[CHANNELS]; ///< Running channels, earliest deadline first.
+    static uint8_t scheduled; ///< Number of valid entries in `order`.
+    static bool initialized;
+    static volatile bool dispatching; ///< Set while `handle()` runs the channel callbacks.
+
+    static inline bool due(const uint8_t channel, const uint32_t now)
+    {
+        return static_cast<int32_t>(now - channels[channel].deadline) >= 0;
+    }
+
+    static void unschedule(const uint8_t channel)
+    {
+        for (uint8_t i = 0; i < scheduled; i++)
+        {
+            if (order[i] == channel)
+            {
+                for (uint8_t j = i + 1; j < scheduled; j++)
+                {
+                    order[j - 1] = order[j];
+                }
+                scheduled--;
+                return;
+            }
+        }
+    }
+
+    static void schedule(const uint8_t channel)
+    {
+        unschedule(channel);
+
+        // channels with the same deadline keep the order they were scheduled in
+        const uint32_t deadline = channels[channel].deadline;
+        uint8_t i = scheduled;
+        while (i > 0 && static_cast<int32_t>(channels[order[i - 1]].deadline - deadline) > 0)
+        {
+            order[i] = order[i - 1];
+            i--;
+        }
+        order[i] = channel;
+        scheduled++;
+    }
+
+    /**
+     * @brief Arm the compare for the earliest deadline after a change outside of `handle()`.
+     */
+    static void rearm()
+    {
+        if (scheduled == 0)
+        {
+            CLOCK::disarm();
+            return;
+        }
+
+        CLOCK::arm(channels[order[0]].deadline);
+
+        // the deadline may already have passed while it was armed
+        if (due(order[0], CLOCK::now()))
+        {
+            handle();
+        }
+    }
+
+public:
+    /**
+     * @brief Start the hardware counter. Further calls are ignored.
+     */
+    static void init()
+    {
+        if (!initialized)
+        {
+            initialized = true;
+            CLOCK::init();
+        }
+    }
+
+    static void setCallback(const uint8_t channel, const timer_callback fn)
+    {
+        channels[channel].callback = fn;
+    }
+
+    /**
+     * @brief Set the interval of `channel` and start it if it is stopped.
+     *
+     * A stopped channel counts its first interval from now. A running channel counts it from its
+     * previous deadline, like a CTC timer whose compare value is changed.
+     */
+    static void setInterval(const uint8_t channel, uint32_t value)
+    {
+        if (value > MAX_INTERVAL)
+        {
+            value = MAX_INTERVAL;
+        }
+
+        const uint8_t state = CLOCK::lock();
+
+        Channel &c = channels[channel];
+        if (!c.active)
+        {
+            c.base = CLOCK::now();
+            c.active = true;
+        }
+        c.deadline = c.base + value;
+        schedule(channel);
+
+        // inside `handle()` the compare is armed once all due channels are served
+        if (!dispatching)
+        {
+            rearm();
+        }
+
+        CLOCK::unlock(state);
+    }
+
+    /**
+     * @brief Stop `channel`. Like `setInterval()` it may be called with interrupts disabled, e.g.
+     * from the commit of a `Stepper`, and leaves them disabled then.
+     */
+    static void stop(const uint8_t channel)
+    {
+        const uint8_t state = CLOCK::lock();
+
+        channels[channel].active = false;
+        unschedule(channel);
+
+        if (!dispatching)
+        {
+            rearm();
+        }
+
+        CLOCK::unlock(state);
+    }
+
+    /**
+     * @brief Run every channel that is due and arm the compare for the next deadline.
+     *
+     * Called by the `CLOCK` backend from its compare interrupt.
+     */
+    static void handle()
+    {
+        dispatching = true;
+
+        for (;;)
+        {
+            while (scheduled > 0 && due(order[0], CLOCK::now()))
+            {
+                const uint8_t channel = order[0];
+                Channel &c = channels[channel];
+
+                // the next interval starts at the deadline, not at the moment it is served
+                const uint32_t interval = c.deadline - c.base;
+                c.base = c.deadline;
+                c.deadline = c.base + interval;
+
+                if (c.callback != nullptr)
+                {
+                    c.callback();
+                }
+
+                if (c.active)
+                {
+                    schedule(channel);
+                }
+            }
+
+            if (scheduled == 0)
+            {
+                CLOCK::disarm();
+                break;
+            }
+
+            CLOCK::arm(channels[order[0]].deadline);
+
+            if (!due(order[0], CLOCK::now()))
+            {
+                break;
+            }
+        }
+
+        dispatching = false;
+    }
+};
+
+template <typename CLOCK, uint8_t CHANNELS>
+typename TimerMultiplexer<CLOCK, CHANNELS>::Channel TimerMultiplexer<CLOCK, CHANNELS>::channels[CHANNELS] = {};
+
+template <typename CLOCK, uint8_t CHANNELS>
+uint8_t TimerMultiplexer<CLOCK, CHANNELS>::order[CHANNELS] = {};
+
+template <typename CLOCK, uint8_t CHANNELS>
+uint8_t TimerMultiplexer<CLOCK, CHANNELS>::scheduled = 0;
+
+template <typename CLOCK, uint8_t CHANNELS>
+bool TimerMultiplexer<CLOCK, CHANNELS>::initialized = false;
+
+template <typename CLOCK, uint8_t CHANNELS>
+volatile bool TimerMultiplexer<CLOCK, CHANNELS>::dispatching = false;
+
+/**
+ * @brief `IntervalInterrupt`-compatible view of one channel of a `TimerMultiplexer`.
+ *
+ * Can be passed to `Stepper` as its `INTERRUPT` parameter, so several steppers share one hardware
+ * timer. Every channel has to be used by exactly one stepper.
+ */
+template <typename MUX, uint8_t CHANNEL>
+class MultiplexedInterrupt
+{
+public:
+    MultiplexedInterrupt() = delete;
+
+    constexpr static int ID = CHANNEL;
+
+    constexpr static uint32_t FREQ = MUX::FREQ;
+
+    static void init()
+    {
+        MUX::init();
+    }
+
+    static inline __attribute__((always_inline)) void setCallback(timer_callback fn)
+    {
+        MUX::setCallback(CHANNEL, fn);
+    }
+
+    static inline __attribute__((always_inline)) void setInterval(uint32_t value)
+    {
+        MUX::setInterval(CHANNEL, value);
+    }
+
+    static inline __attribute__((always_inline)) void stop()
+    {
+        MUX::stop(CHANNEL);
+    }
+};
+
+#if defined(ARDUINO_ARCH_AVR)
+
+/**
+ * @brief Free-running 32-bit counter on a 16-bit AVR timer for `TimerMultiplexer`.
+ *
+ * The timer runs in normal mode at the CPU clock. Overflows extend the counter to 32 bits, and
+ * compare channel A fires once the armed deadline is reached within the current overflow period.
+ */
+template <Timer T>
+struct FreeRunningClock_AVR
+{
+    using Registers = IntervalInterrupt_AVR<T>;
+
+    constexpr static uint32_t FREQ = F_CPU;
+
+    static volatile uint16_t high; ///< Upper 16 bits of the counter, incremented on overflow.
+    static volatile uint16_t armed_high; ///< Upper 16 bits of the armed deadline.
+    static volatile bool armed;
+
+    static void init()
+    {
+        cli();
+        *Registers::TCCRA() = 0;
+        *Registers::TCCRB() = 0;
+        *Registers::TCNT() = 0;
+        high = 0;
+        armed = false;
+        *Registers::TIMSK() = bit(0); // overflow interrupt only
+        *Registers::TCCRB() = 1;      // normal mode, prescaler 1
+        sei();
+    }
+
+    static inline uint32_t now()
+    {
+        const uint8_t sreg = SREG;
+        cli();
+        const uint16_t low = *Registers::TCNT();
+        uint16_t upper = high;
+        // an overflow whose interrupt has not run yet is not counted in `high`
+        if ((*Registers::TIFR() & bit(0)) != 0 && low < 0x8000)
+        {
+            upper++;
+        }
+        SREG = sreg;
+        return (static_cast<uint32_t>(upper) << 16) | low;
+    }
+
+    static inline void arm(const uint32_t deadline)
+    {
+        armed_high = static_cast<uint16_t>(deadline >> 16);
+        *Registers::OCRA() = static_cast<uint16_t>(deadline);
+        armed = true;
+
+        // clear a compare flag left over from an earlier period
+        *Registers::TIFR() |= (1 << 1);
+
+        if (armed_high == static_cast<uint16_t>(now() >> 16))
+        {
+            *Registers::TIMSK() |= (1 << 1);
+        }
+        else
+        {
+            // enabled by the overflow that reaches the deadline's period
+            *Registers::TIMSK() &= ~(1 << 1);
+        }
+    }
+
+    static inline void disarm()
+    {
+        armed = false;
+        *Registers::TIMSK() &= ~(1 << 1);
+    }
+
+    static inline __attribute__((always_inline)) uint8_t lock()
+    {
+        const uint8_t sreg = SREG;
+        cli();
+        return sreg;
+    }
+
+    static inline __attribute__((always_inline)) void unlock(const uint8_t sreg)
+    {
+        SREG = sreg;
+    }
+
+    /**
+     * @return `true` if the armed deadline has already passed within the new period.
+     */
+    static inline __attribute__((always_inline)) bool handle_overflow()
+    {
+        high++;
+
+        if (armed && armed_high == high)
+        {
+            if (*Registers::TCNT() >= *Registers::OCRA())
+            {
+                disarm();
+                return true;
+            }
+
+            *Registers::TIFR() |= (1 << 1);
+            *Registers::TIMSK() |= (1 << 1);
+        }
+
+        return false;
+    }
+
+    static inline __attribute__((always_inline)) bool handle_compare_match()
+    {
+        if (!armed)
+        {
+            return false;
+        }
+
+        disarm();
+        return true;
+    }
+};
+
+template <Timer T>
+volatile uint16_t FreeRunningClock_AVR<T>::high = 0;
+
+template <Timer T>
+volatile uint16_t FreeRunningClock_AVR<T>::armed_high = 0;
+
+template <Timer T>
+volatile bool FreeRunningClock_AVR<T>::armed = false;
+
+/**
+ * @brief Route the interrupts of AVR timer `x` to the multiplexer `MUX`.
+ *
+ * `MUX` has to be a `TimerMultiplexer<FreeRunningClock_AVR<Timer::TIMER_x>, N>`. The timer can not
+ * be used by `STEPPER_USE_TIMER` at the same time.
+ */
+#define STEPPER_USE_MULTIPLEXED_TIMER(x, MUX)                                          \
+    ISR(TIMER##x##_OVF_vect)                                                           \
+    {                                                                                  \
+        if (FreeRunningClock_AVR<Timer::TIMER_##x>::handle_overflow())                 \
+        {                                                                              \
+            INTERRUPT_TIMING_START();                                                  \
+            MUX::handle();                                                             \
+            INTERRUPT_TIMING_END();                                                    \
+        }                                                                              \
+    }                                                                                  \
+    ISR(TIMER##x##_COMPA_vect)                                                         \
+    {                                                                                  \
+        if (FreeRunningClock_AVR<Timer::TIMER_##x>::handle_compare_match())            \
+        {                                                                              \
+            INTERRUPT_TIMING_START();                                                  \
+            MUX::handle();                                                             \
+            INTERRUPT_TIMING_END();                                                    \
+        }                                                                              \
+    }
+
+#endif
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace internal
+{
+    /**
+     * @brief One interval of a 16 bit AVR timer in CTC mode, in prescaled timer ticks.
+     *
+     * The timer counts `ovf` full overflows and then `ocr + 1` ticks up to the compare match, so
+     * the interval is `((ovf << 16) + ocr + 1) << shift` CPU cycles.
+     */
+    struct PrescaledInterval
+    {
+        uint8_t cs;    ///< CSn2:0 bits of TCCRnB
+        uint8_t shift; ///< log2 of the prescaler
+        uint8_t ovf;   ///< overflows before the compare match counts
+        uint16_t ocr;  ///< compare value of the last stretch
+    };
+
+    /**
+     * @brief Prescaler selection of the ATmega 16 bit timers: 1, 8, 64, 256 or 1024.
+     *
+     * Each interval runs on the smallest prescaler whose 16 bit range still holds it, so only
+     * intervals beyond 1024 * 65536 cycles (4.2 s at 16 MHz) need overflow interrupts. At prescaler
+     * 1 and below 65536 cycles nothing changes compared to a fixed prescaler.
+     */
+    struct TimerPrescaler
+    {
+        constexpr static uint8_t COUNT = 5;
+
+        /// log2 of prescaler `index`.
+        constexpr static uint8_t shift(const uint8_t index)
+        {
+            constexpr uint8_t SHIFTS[COUNT] = {0, 3, 6, 8, 10};
+            return SHIFTS[index];
+        }
+
+        /// Index of the smallest prescaler that counts `cycles` without an overflow, the largest if none does.
+        constexpr static uint8_t select(const uint32_t cycles)
+        {
+            for (uint8_t index = 0; index < COUNT - 1; index++)
+            {
+                if (cycles <= (0x10000UL << shift(index)))
+                {
+                    return index;
+                }
+            }
+            return COUNT - 1;
+        }
+
+        /**
+         * @brief Split an interval of `cycles` CPU cycles for the timer.
+         *
+         * The cycles below one prescaled tick are carried over in `residue` and added to the next
+         * interval. As long as every interval goes through `split()`, also one the timer repeats
+         * unchanged, each compare match lands less than one prescaled tick before its ideal time and
+         * the error does not accumulate.
+         *
+         * @param cycles Interval in CPU cycles, at least 1.
+         * @param residue Carry from the previous interval, 0 after the timer was stopped.
+         */
+        static inline __attribute__((always_inline)) PrescaledInterval split(const uint32_t cycles, uint16_t &residue)
+        {
+            const uint32_t total = cycles + residue;
+            const uint8_t index = select(total);
+            const uint8_t s = shift(index);
+
+            residue = static_cast<uint16_t>(total & ((1UL << s) - 1));
+
+            // at least one tick: only prescaler 1 is ever chosen for less than 65536 cycles
+            const uint32_t last = (total >> s) - 1;
+            return PrescaledInterval{static_cast<uint8_t>(index + 1), s, static_cast<uint8_t>(last >> 16), static_cast<uint16_t>(last & 0xFFFF)};
+        }
+    };
+}
@@ -0,0 +1,423 @@
+#include <vector>
+
+#include "CompareChannels.h"
+#include "Stepper.h"
+
+#include "gtest/gtest.h"
+
+namespace
+{
+/**
+ * @brief Register model of a free-running 16 bit AVR timer with three compare units.
+ *
+ * Flags are raised as time passes, whether their interrupt is enabled or not, and `run()` enters
+ * the pending vectors in hardware priority order: compare A, B, C, then the overflow. Like the
+ * real counter it never restarts, tests go on from wherever the previous one left it.
+ */
+struct ModelTimer
+{
+  using Engine = CompareChannels<ModelTimer>;
+
+  constexpr static uint32_t FREQ = F_CPU;
+
+  static uint64_t time;
+  static bool tov;
+  static uint8_t ocf;  ///< compare flags, bit n for channel n
+  static uint8_t ocie; ///< compare interrupt enables, bit n for channel n
+  static uint16_t ocr[3];
+
+  static void start()
+  {
+  }
+
+  static uint16_t count()
+  {
+    return static_cast<uint16_t>(time);
+  }
+
+  static bool overflowPending()
+  {
+    return tov;
+  }
+
+  static void setCompare(const uint8_t channel, const uint16_t value)
+  {
+    ocr[channel] = value;
+  }
+
+  static void enableCompare(const uint8_t channel)
+  {
+    ocf &= ~(1U << channel);
+    ocie |= (1U << channel);
+  }
+
+  static void disableCompare(const uint8_t channel)
+  {
+    ocie &= ~(1U << channel);
+  }
+
+  static uint8_t lock()
+  {
+    return 0;
+  }
+
+  static void unlock(uint8_t)
+  {
+  }
+
+  /// First time after `time` at which the counter equals the compare value of `channel`.
+  static uint64_t nextMatch(const uint8_t channel)
+  {
+    uint64_t match = (time & ~0xFFFFULL) | ocr[channel];
+    return (match <= time) ? match + 0x10000 : match;
+  }
+
+  /// Let the counter run until `to` and raise every flag it passes.
+  static void advance(const uint64_t to)
+  {
+    if ((to >> 16) > (time >> 16))
+    {
+      tov = true;
+    }
+    for (uint8_t channel = 0; channel < 3; channel++)
+    {
+      if (nextMatch(channel) <= to)
+      {
+        ocf |= (1U << channel);
+      }
+    }
+    time = to;
+  }
+
+  /**
+   * @brief Run the timer while `busy()` holds. Every vector is entered `latency()` ticks after the
+   * flag that triggers it, or after the previous vector when they collide.
+   */
+  template <typename BUSY, typename LATENCY>
+  static void run(BUSY busy, LATENCY latency)
+  {
+    while (busy())
+    {
+      const uint8_t pending = ocf & ocie;
+      if (pending != 0)
+      {
+        const uint8_t channel = (pending & 1) ? 0 : ((pending & 2) ? 1 : 2);
+        advance(time + latency());
+        ocf &= ~(1U << channel);
+        Engine::handle_compare(channel);
+      }
+      else if (tov)
+      {
+        advance(time + latency());
+        tov = false;
+        Engine::handle_overflow();
+      }
+      else
+      {
+        uint64_t next = ((time >> 16) + 1) << 16;
+        for (uint8_t channel = 0; channel < 3; channel++)
+        {
+          if ((ocie & (1U << channel)) != 0 && nextMatch(channel) < next)
+          {
+            next = nextMatch(channel);
+          }
+        }
+        advance(next);
+      }
+    }
+  }
+};
+
+uint64_t ModelTimer::time = 0;
+bool ModelTimer::tov = false;
+uint8_t ModelTimer::ocf = 0;
+uint8_t ModelTimer::ocie = 0;
+uint16_t ModelTimer::ocr[3] = {};
+
+/**
+ * @brief Channel backend that checks every interrupt of a stepper against its programmed intervals.
+ *
+ * An interval is due one interval after the previous due time, or after the time it was programmed
+ * for the first one of a move. The interrupt may run late, but the lateness must not accumulate.
+ */
+template <uint8_t CHANNEL>
+struct Recorder
+{
+  using View = ChannelInterrupt<ModelTimer::Engine, CHANNEL>;
+
+  constexpr static int ID = CHANNEL;
+  constexpr static uint32_t FREQ = View::FREQ;
+
+  static timer_callback target;
+  static bool running;
+  static uint64_t start;  ///< time the move started
+  static uint64_t origin; ///< due time of the running interrupt
+  static uint64_t due;    ///< time the next interrupt is due
+  static uint32_t interval;
+  static uint64_t max_lateness;
+  static std::vector<uint64_t> times; ///< due times relative to `start`
+
+  static void init()
+  {
+    View::init();
+  }
+
+  static void setCallback(const timer_callback fn)
+  {
+    target = fn;
+    View::setCallback(fire);
+  }
+
+  static void setInterval(const uint32_t value)
+  {
+    if (!running)
+    {
+      start = ModelTimer::time;
+      origin = start;
+      running = true;
+    }
+    interval = value;
+    due = origin + value;
+    View::setInterval(value);
+  }
+
+  static void stop()
+  {
+    running = false;
+    View::stop();
+  }
+
+  static uint32_t elapsed()
+  {
+    return View::elapsed();
+  }
+
+  static void reset()
+  {
+    running = false;
+    start = 0;
+    origin = 0;
+    due = 0;
+    max_lateness = 0;
+    times.clear();
+  }
+
+  static void fire()
+  {
+    // never early, and late by no more than the interrupts in front of it
+    EXPECT_GE(ModelTimer::time, due);
+    const uint64_t lateness = ModelTimer::time - due;
+    max_lateness = (lateness > max_lateness) ? lateness : max_lateness;
+
+    origin = due;
+    due = origin + interval;
+    times.push_back(origin - start);
+    target();
+  }
+};
+
+template <uint8_t CHANNEL>
+timer_callback Recorder<CHANNEL>::target = nullptr;
+template <uint8_t CHANNEL>
+bool Recorder<CHANNEL>::running = false;
+template <uint8_t CHANNEL>
+uint64_t Recorder<CHANNEL>::start = 0;
+template <uint8_t CHANNEL>
+uint64_t Recorder<CHANNEL>::origin = 0;
+template <uint8_t CHANNEL>
+uint64_t Recorder<CHANNEL>::due = 0;
+template <uint8_t CHANNEL>
+uint32_t Recorder<CHANNEL>::interval = 0;
+template <uint8_t CHANNEL>
+uint64_t Recorder<CHANNEL>::max_lateness = 0;
+template <uint8_t CHANNEL>
+std::vector<uint64_t> Recorder<CHANNEL>::times;
+
+/// Driver that counts its steps.
+template <uint8_t CHANNEL>
+struct CountingDriver
+{
+  constexpr static uint32_t SPR = 400 * 256;
+
+  static uint32_t steps;
+
+  static void init()
+  {
+  }
+
+  static void step()
+  {
+    steps++;
+  }
+
+  static void dir(bool)
+  {
+  }
+
+  static void setInverted(bool)
+  {
+  }
+};
+
+template <uint8_t CHANNEL>
+uint32_t CountingDriver<CHANNEL>::steps = 0;
+
+using Ramp = AccelerationRamp<256, F_CPU, 40352, 40352>;
+using StepperA = Stepper<Recorder<0>, CountingDriver<0>, Ramp>;
+using StepperB = Stepper<Recorder<1>, CountingDriver<1>, Ramp>;
+using StepperC = Stepper<Recorder<2>, CountingDriver<2>, Ramp>;
+
+/// Interrupt entry between 10 and 89 ticks from a fixed pseudo random sequence.
+struct Jitter
+{
+  uint32_t state;
+
+  uint32_t operator()()
+  {
+    state = state * 1103515245U + 12345U;
+    return 10 + ((state >> 16) % 80);
+  }
+};
+
+bool anyRunning()
+{
+  return Recorder<0>::running || Recorder<1>::running || Recorder<2>::running;
+}
+
+void resetAll()
+{
+  Recorder<0>::reset();
+  Recorder<1>::reset();
+  Recorder<2>::reset();
+  CountingDriver<0>::steps = 0;
+  CountingDriver<1>::steps = 0;
+  CountingDriver<2>::steps = 0;
+  StepperA::reset();
+  StepperB::reset();
+  StepperC::reset();
+}
+} // namespace
+
+struct CompareChannelsTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    resetAll();
+  }
+
+  void TearDown() override
+  {
+    StepperA::terminate(false);
+    StepperB::terminate(false);
+    StepperC::terminate(false);
+    resetAll();
+  }
+};
+
+// Three steppers on one timer reach their targets, each exactly on its own programmed schedule.
+TEST_F(CompareChannelsTest, ThreeSteppersRunIndependently)
+{
+  StepperA::moveTo(5000.0f, 6000);
+  StepperB::moveTo(3000.0f, -4000);
+  StepperC::moveTo(800.0f, 1000);
+  ModelTimer::run(anyRunning, Jitter{1});
+
+  EXPECT_EQ(6000, StepperA::getPosition());
+  EXPECT_EQ(-4000, StepperB::getPosition());
+  EXPECT_EQ(1000, StepperC::getPosition());
+  EXPECT_EQ(6000U, CountingDriver<0>::steps);
+  EXPECT_EQ(4000U, CountingDriver<1>::steps);
+  EXPECT_EQ(1000U, CountingDriver<2>::steps);
+
+  // lateness is bounded by the vectors that can be in front of one, it never accumulates
+  EXPECT_LT(Recorder<0>::max_lateness, 4U * 90U);
+  EXPECT_LT(Recorder<1>::max_lateness, 4U * 90U);
+  EXPECT_LT(Recorder<2>::max_lateness, 4U * 90U);
+}
+
+// A channel's schedule does not depend on the other channels or on the interrupt latency.
+TEST_F(CompareChannelsTest, ScheduleDoesNotDependOnOtherChannels)
+{
+  StepperB::moveTo(3000.0f, 4000);
+  ModelTimer::run(anyRunning, Jitter{1});
+  const std::vector<uint64_t> alone = Recorder<1>::times;
+
+  resetAll();
+  StepperA::moveTo(5000.0f, 6000);
+  StepperB::moveTo(3000.0f, 4000);
+  StepperC::moveTo(800.0f, 1000);
+  ModelTimer::run(anyRunning, Jitter{0xC0FFEE});
+
+  EXPECT_EQ(4000U, alone.size());
+  EXPECT_EQ(alone, Recorder<1>::times);
+}
+
+// Intervals longer than an overflow period are armed from the overflow of the period they end in.
+TEST_F(CompareChannelsTest, LongIntervalsSpanOverflows)
+{
+  StepperC::moveTo(20.0f, 100);
+  ModelTimer::run(anyRunning, Jitter{7});
+
+  EXPECT_EQ(100, StepperC::getPosition());
+  EXPECT_GT(Recorder<2>::times.back(), 99ULL * (F_CPU / 20));
+  EXPECT_LT(Recorder<2>::max_lateness, 2U * 90U);
+}
+
+// A stopped channel disables its compare interrupt, the counter keeps running for the others.
+TEST_F(CompareChannelsTest, StopDisablesOnlyItsChannel)
+{
+  using Engine = ModelTimer::Engine;
+
+  Engine::setCallback(0, [] {});
+  Engine::setCallback(1, [] {});
+  // start at the beginning of a period, so both deadlines fall into it
+  ModelTimer::run([] { return ModelTimer::tov || (ModelTimer::time & 0xFFFF) != 0; }, [] { return 0U; });
+  const uint64_t now = ModelTimer::time;
+  EXPECT_EQ(now, Engine::now());
+
+  Engine::setInterval(0, 1000);
+  Engine::setInterval(1, 2000);
+  EXPECT_EQ(0x3U, ModelTimer::ocie);
+  EXPECT_EQ(static_cast<uint16_t>(now + 1000), ModelTimer::ocr[0]);
+  EXPECT_EQ(static_cast<uint16_t>(now + 2000), ModelTimer::ocr[1]);
+
+  Engine::stop(0);
+  EXPECT_EQ(0x2U, ModelTimer::ocie);
+
+  // a deadline beyond the current period waits for the overflow
+  Engine::setInterval(0, 70000);
+  EXPECT_EQ(0x2U, ModelTimer::ocie);
+  EXPECT_EQ(static_cast<uint16_t>(now + 70000), ModelTimer::ocr[0]);
+
+  Engine::stop(0);
+  Engine::stop(1);
+  EXPECT_EQ(0U, ModelTimer::ocie);
+}
+
+// Channels started while held wait for the release and count their first interval from it.
+TEST_F(CompareChannelsTest, ReleasedChannelsShareTheirFirstBase)
+{
+  using Engine = ModelTimer::Engine;
+
+  static uint64_t fired[2];
+  fired[0] = 0;
+  fired[1] = 0;
+  Engine::setCallback(0, [] { fired[0] = ModelTimer::time; Engine::stop(0); });
+  Engine::setCallback(1, [] { fired[1] = ModelTimer::time; Engine::stop(1); });
+
+  Engine::hold();
+  Engine::setInterval(0, 1000);
+  ModelTimer::advance(ModelTimer::time + 300);
+  Engine::setInterval(1, 1000);
+  ModelTimer::advance(ModelTimer::time + 2000);
+  EXPECT_EQ(0U, ModelTimer::ocie);
+
+  const uint64_t released = ModelTimer::time;
+  EXPECT_EQ(static_cast<uint32_t>(released), Engine::now());
+  Engine::release();
+  ModelTimer::run([] { return fired[0] == 0 || fired[1] == 0; }, [] { return 0U; });
+
+  EXPECT_EQ(released + 1000, fired[0]);
+  EXPECT_EQ(released + 1000, fired[1]);
+}
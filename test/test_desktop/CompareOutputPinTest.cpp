@@ -0,0 +1,288 @@
+#include <vector>
+
+#include "CompareOutputPin.h"
+#include "Driver.h"
+#include "IntervalInterrupt.h"
+#include "Stepper.h"
+
+#include "gtest/gtest.h"
+
+namespace
+{
+/**
+ * @brief Register model of output compare unit A of an AVR 16 bit timer.
+ *
+ * Only what `CompareOutputPin` touches: COMnA1:0 in TCCRnA, the FOCnA strobe in TCCRnC and the
+ * OCnA latch, whose edges are recorded with the current model time.
+ */
+struct ModelTimer
+{
+  /// TCCRnC: writing FOCnA applies the compare output action immediately, it always reads as zero.
+  struct ForceStrobe
+  {
+    ForceStrobe &operator=(const uint8_t value)
+    {
+      if ((value & CompareOutputPin<ModelTimer>::FOC) != 0)
+      {
+        compare();
+      }
+      return *this;
+    }
+  };
+
+  static volatile uint8_t tccra;
+  static ForceStrobe tccrc;
+  static volatile uint8_t com_bits;
+
+  static bool latch;
+  static uint64_t now;
+  static std::vector<uint64_t> rising;
+  static std::vector<uint64_t> falling;
+
+  static volatile uint8_t *TCCRA()
+  {
+    return &tccra;
+  }
+
+  static ForceStrobe *TCCRC()
+  {
+    return &tccrc;
+  }
+
+  static void initCompareOutput()
+  {
+  }
+
+  /// Compare output action selected by COMnA1:0, on a compare match or a forced compare.
+  static void compare()
+  {
+    switch ((tccra >> 6) & 0b11)
+    {
+    case 0b01:
+      set(!latch);
+      break;
+    case 0b10:
+      set(false);
+      break;
+    case 0b11:
+      set(true);
+      break;
+    default:
+      // disconnected, the pin follows its port bit
+      break;
+    }
+  }
+
+  static void set(const bool level)
+  {
+    if (level && !latch)
+    {
+      rising.push_back(now);
+    }
+    else if (!level && latch)
+    {
+      falling.push_back(now);
+    }
+    latch = level;
+  }
+
+  static void reset()
+  {
+    tccra = 0;
+    com_bits = 0;
+    latch = false;
+    now = 0;
+    rising.clear();
+    falling.clear();
+  }
+};
+
+volatile uint8_t ModelTimer::tccra = 0;
+ModelTimer::ForceStrobe ModelTimer::tccrc;
+volatile uint8_t ModelTimer::com_bits = 0;
+bool ModelTimer::latch = false;
+uint64_t ModelTimer::now = 0;
+std::vector<uint64_t> ModelTimer::rising;
+std::vector<uint64_t> ModelTimer::falling;
+
+/**
+ * @brief CTC timer around `ModelTimer`: a compare match fires the output action first and the
+ * handler `latency` ticks later. An interval programmed in the handler ends the current period.
+ */
+struct ModelInterrupt
+{
+  constexpr static unsigned long int FREQ = F_CPU;
+
+  static timer_callback callback;
+  static uint32_t interval;
+  static std::vector<uint32_t> periods;
+
+  static void init()
+  {
+  }
+
+  static void setCallback(const timer_callback fn)
+  {
+    callback = fn;
+  }
+
+  static void setInterval(const uint32_t value)
+  {
+    interval = value;
+  }
+
+  static void stop()
+  {
+    callback = nullptr;
+  }
+
+  template <typename LATENCY>
+  static void run(LATENCY latency)
+  {
+    uint64_t match = 0;
+    while (callback != nullptr)
+    {
+      match += interval;
+      periods.push_back(interval);
+
+      ModelTimer::now = match;
+      ModelTimer::compare();
+
+      ModelTimer::now = match + latency();
+      callback();
+    }
+  }
+};
+
+timer_callback ModelInterrupt::callback = nullptr;
+uint32_t ModelInterrupt::interval = 0;
+std::vector<uint32_t> ModelInterrupt::periods;
+
+struct NullPin
+{
+  static void init()
+  {
+  }
+
+  static void high()
+  {
+  }
+
+  static void low()
+  {
+  }
+};
+
+using StepPin = CompareOutputPin<ModelTimer>;
+using HardwareStepper = Stepper<ModelInterrupt, Driver<StepPin, NullPin>, AccelerationRamp<256, F_CPU, 40352, 40352>>;
+
+/// Interrupt latency between 20 and 339 ticks from a fixed pseudo random sequence.
+struct Jitter
+{
+  uint32_t state;
+
+  uint32_t operator()()
+  {
+    state = state * 1103515245U + 12345U;
+    return 20 + ((state >> 16) % 320);
+  }
+};
+} // namespace
+
+struct CompareOutputPinTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    ModelTimer::reset();
+    ModelInterrupt::periods.clear();
+  }
+
+  void TearDown() override
+  {
+    HardwareStepper::terminate(false);
+    HardwareStepper::reset();
+  }
+
+  /// Run one move and return the rising edges it produced.
+  static std::vector<uint64_t> runMove(const uint32_t seed)
+  {
+    ModelTimer::reset();
+    ModelInterrupt::periods.clear();
+    StepPin::init();
+
+    HardwareStepper::reset();
+    HardwareStepper::moveTo(20000.0f, 5000);
+    ModelInterrupt::run(Jitter{seed});
+
+    return ModelTimer::rising;
+  }
+};
+
+// init() connects the output in set-on-match mode, leaves the other TCCRnA bits alone and starts low.
+TEST_F(CompareOutputPinTest, InitArmsSetOnMatch)
+{
+  ModelTimer::tccra = 0b00000011;
+  ModelTimer::latch = true;
+
+  StepPin::init();
+
+  EXPECT_EQ(StepPin::COM_SET | 0b00000011, ModelTimer::tccra);
+  EXPECT_EQ(StepPin::COM_SET, ModelTimer::com_bits);
+  EXPECT_FALSE(ModelTimer::latch);
+}
+
+// Forcing a level goes through the compare unit and restores the output mode afterwards, also while
+// the backend has the output disconnected to count overflows.
+TEST_F(CompareOutputPinTest, ForcedLevelsKeepOutputMode)
+{
+  StepPin::init();
+
+  StepPin::high();
+  EXPECT_TRUE(ModelTimer::latch);
+  EXPECT_EQ(StepPin::COM_SET, ModelTimer::tccra);
+
+  ModelTimer::tccra &= ~ModelTimer::com_bits;
+  StepPin::low();
+  EXPECT_FALSE(ModelTimer::latch);
+  EXPECT_EQ(0, ModelTimer::tccra);
+
+  // disconnected, a compare match leaves the pin alone
+  ModelTimer::compare();
+  EXPECT_FALSE(ModelTimer::latch);
+}
+
+// Every rising edge sits exactly on its compare match, so the edge spacing equals the programmed
+// intervals no matter how late the handler runs. The handler only ends each pulse.
+TEST_F(CompareOutputPinTest, RisingEdgesFollowProgrammedIntervals)
+{
+  const std::vector<uint64_t> rising = runMove(1);
+  const std::vector<uint64_t> &falling = ModelTimer::falling;
+  const std::vector<uint32_t> &periods = ModelInterrupt::periods;
+
+  ASSERT_EQ(5000U, rising.size());
+  ASSERT_EQ(rising.size(), falling.size());
+  ASSERT_EQ(rising.size(), periods.size());
+  EXPECT_EQ(5000, HardwareStepper::getPosition());
+
+  uint64_t expected = 0;
+  bool spacing = true;
+  bool width = true;
+  for (size_t i = 0; i < rising.size(); i++)
+  {
+    expected += periods[i];
+    spacing = spacing && (rising[i] == expected);
+    width = width && (falling[i] > rising[i]) && (falling[i] - rising[i] < periods[i]);
+  }
+  EXPECT_TRUE(spacing);
+  EXPECT_TRUE(width);
+}
+
+// Two runs with different handler latencies produce identical step edges.
+TEST_F(CompareOutputPinTest, EdgesDoNotDependOnLatency)
+{
+  const std::vector<uint64_t> first = runMove(1);
+  const std::vector<uint64_t> second = runMove(0xC0FFEE);
+
+  EXPECT_EQ(first, second);
+}
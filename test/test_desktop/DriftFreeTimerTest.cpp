@@ -0,0 +1,563 @@
+#include <vector>
+
+#include "CompareOutputPin.h"
+#include "DriftFreeTimer.h"
+#include "Stepper.h"
+#include "SyncStart.h"
+
+#include "gtest/gtest.h"
+
+namespace
+{
+/**
+ * @brief Register model of an upcounting STM32 timer with ARR preload off.
+ *
+ * Only what `DriftFreeTimer` touches. Writing UG to EGR restarts the counter and raises the update
+ * flag, the counter itself only advances in `ModelSource::run()`. Output compare channel 1 keeps its
+ * output level in `oc1` and records its edges at `now`.
+ */
+struct ModelTim
+{
+  /// CCMR1: the forced OC1M modes set the output as soon as they are written.
+  struct CompareMode
+  {
+    ModelTim *tim;
+    uint32_t value = 0;
+
+    CompareMode &operator=(const uint32_t v)
+    {
+      value = v;
+      if (mode() == 0b100)
+      {
+        tim->output(false);
+      }
+      else if (mode() == 0b101)
+      {
+        tim->output(true);
+      }
+      return *this;
+    }
+
+    operator uint32_t() const
+    {
+      return value;
+    }
+
+    uint32_t mode() const
+    {
+      return (value >> 4) & 0b111;
+    }
+  };
+
+  struct UpdateStrobe
+  {
+    ModelTim *tim;
+
+    UpdateStrobe &operator=(const uint32_t value)
+    {
+      if ((value & 1) != 0)
+      {
+        tim->CNT = 0;
+        tim->SR |= 1;
+        tim->forced++;
+      }
+      return *this;
+    }
+  };
+
+  uint32_t CR1 = 0;
+  uint32_t SR = 0;
+  UpdateStrobe EGR{this};
+  uint32_t CNT = 0;
+  uint32_t ARR = 0;
+  CompareMode CCMR1{this};
+  uint32_t CCER = 0;
+  uint32_t CCR1 = 0xFFFF;
+
+  uint32_t forced = 0;
+
+  bool oc1 = false;
+  uint64_t now = 0;
+  std::vector<uint64_t> rising;
+  std::vector<uint64_t> falling;
+
+  void output(const bool level)
+  {
+    if (level != oc1)
+    {
+      (level ? rising : falling).push_back(now);
+    }
+    oc1 = level;
+  }
+
+  /// The counter passes 0: channel 1 matches with CCR1 at 0 and acts on an active-on-match mode.
+  void wrap(const uint64_t time)
+  {
+    if (CCR1 == 0 && (CCER & 1) != 0 && CCMR1.mode() == 0b001)
+    {
+      now = time;
+      output(true);
+    }
+  }
+};
+
+/// Hardware access of `DriftFreeTimer` on a `ModelTim`, with a 16 or a 32 bit counter.
+template <uint8_t ID, bool WIDE>
+struct ModelSource
+{
+  using Regs = ModelTim;
+  using Engine = internal::DriftFreeTimer<ModelSource<ID, WIDE>>;
+
+  constexpr static uint32_t FREQ = F_CPU;
+
+  static ModelTim tim;
+  static uint64_t event; ///< time of the last update event
+  static uint32_t updates;
+
+  static Regs *regs()
+  {
+    return &tim;
+  }
+
+  static bool wide()
+  {
+    return WIDE;
+  }
+
+  static void init()
+  {
+  }
+
+  static void initCompareOutput(uint32_t)
+  {
+  }
+
+  static void resume()
+  {
+    tim.CR1 |= 1;
+  }
+
+  static void pause()
+  {
+    tim.CR1 &= ~1UL;
+  }
+
+  static void reset()
+  {
+    tim = ModelTim{};
+    tim.EGR.tim = &tim;
+    tim.CCMR1.tim = &tim;
+    event = 0;
+    updates = 0;
+  }
+
+  /**
+   * @brief Run the timer until it is stopped. The update handler runs `latency()` ticks after each
+   * update event, while the counter keeps counting.
+   */
+  template <typename LATENCY>
+  static void run(LATENCY latency)
+  {
+    uint64_t zero = 0 - static_cast<uint64_t>(tim.CNT); // time at which the counter was 0
+    while ((tim.CR1 & 1) != 0)
+    {
+      event = zero + tim.ARR + 1;
+      updates++;
+      tim.wrap(event);
+
+      const uint32_t late = latency();
+      tim.CNT = late;
+      tim.now = event + late;
+      zero = event;
+
+      const uint32_t forced = tim.forced;
+      Engine::handle_update();
+      if (tim.forced != forced)
+      {
+        zero = event + late;
+      }
+    }
+  }
+};
+
+template <uint8_t ID, bool WIDE>
+ModelTim ModelSource<ID, WIDE>::tim;
+template <uint8_t ID, bool WIDE>
+uint64_t ModelSource<ID, WIDE>::event = 0;
+template <uint8_t ID, bool WIDE>
+uint32_t ModelSource<ID, WIDE>::updates = 0;
+
+/**
+ * @brief Timer backend that checks every interrupt of the stepper against its programmed interval.
+ *
+ * An interval counts from the interrupt that programmed it, or from 0 for the first one of a move.
+ * Without further programming the timer repeats it.
+ */
+template <typename SOURCE>
+struct Recorder
+{
+  using Engine = typename SOURCE::Engine;
+
+  constexpr static uint32_t FREQ = SOURCE::FREQ;
+
+  static timer_callback target;
+  static uint64_t origin; ///< time of the running interrupt
+  static uint64_t due;    ///< time the next interrupt is due
+  static uint32_t interval;
+  static uint32_t callbacks;
+  static uint32_t misses;
+
+  static void init()
+  {
+    Engine::init();
+  }
+
+  static void setCallback(const timer_callback fn)
+  {
+    target = fn;
+    Engine::setCallback(fire);
+  }
+
+  static void setInterval(const uint32_t value)
+  {
+    interval = value;
+    due = origin + value;
+    Engine::setInterval(value);
+  }
+
+  static void stop()
+  {
+    Engine::stop();
+  }
+
+  static uint32_t elapsed()
+  {
+    return Engine::elapsed();
+  }
+
+  static void reset()
+  {
+    origin = 0;
+    due = 0;
+    callbacks = 0;
+    misses = 0;
+  }
+
+  static void fire()
+  {
+    origin = SOURCE::event;
+    misses += (origin != due) ? 1 : 0;
+    callbacks++;
+    due = origin + interval;
+    target();
+  }
+};
+
+template <typename SOURCE>
+timer_callback Recorder<SOURCE>::target = nullptr;
+template <typename SOURCE>
+uint64_t Recorder<SOURCE>::origin = 0;
+template <typename SOURCE>
+uint64_t Recorder<SOURCE>::due = 0;
+template <typename SOURCE>
+uint32_t Recorder<SOURCE>::interval = 0;
+template <typename SOURCE>
+uint32_t Recorder<SOURCE>::callbacks = 0;
+template <typename SOURCE>
+uint32_t Recorder<SOURCE>::misses = 0;
+
+/// Driver that records the update event of every step.
+template <typename SOURCE>
+struct EventDriver
+{
+  constexpr static uint32_t SPR = 400 * 256;
+
+  static std::vector<uint64_t> times;
+
+  static void init()
+  {
+  }
+
+  static void step()
+  {
+    times.push_back(SOURCE::event);
+  }
+
+  static void dir(bool)
+  {
+  }
+
+  static void setInverted(bool)
+  {
+  }
+};
+
+template <typename SOURCE>
+std::vector<uint64_t> EventDriver<SOURCE>::times;
+
+using Narrow = ModelSource<0, false>;
+using Wide = ModelSource<1, true>;
+
+using Ramp = AccelerationRamp<256, F_CPU, 40352, 40352>;
+using NarrowStepper = Stepper<Recorder<Narrow>, EventDriver<Narrow>, Ramp>;
+using WideStepper = Stepper<Recorder<Wide>, EventDriver<Wide>, Ramp>;
+
+/// Interrupt latency between 20 and 339 ticks from a fixed pseudo random sequence.
+struct Jitter
+{
+  uint32_t state;
+
+  uint32_t operator()()
+  {
+    state = state * 1103515245U + 12345U;
+    return 20 + ((state >> 16) % 320);
+  }
+};
+
+/// Step times of one move: a full ramp up to 5000 steps/s and down again.
+template <typename SOURCE, typename STEPPER>
+std::vector<uint64_t> runRamp(const uint32_t seed)
+{
+  SOURCE::reset();
+  Recorder<SOURCE>::reset();
+  EventDriver<SOURCE>::times.clear();
+
+  STEPPER::reset();
+  STEPPER::moveTo(5000.0f, 20000);
+  SOURCE::run(Jitter{seed});
+
+  return EventDriver<SOURCE>::times;
+}
+
+/// Assert that every interrupt came exactly when the intervals programmed before it said.
+template <typename SOURCE>
+void expectNoDrift()
+{
+  EXPECT_GT(Recorder<SOURCE>::callbacks, 0U);
+  EXPECT_EQ(0U, Recorder<SOURCE>::misses);
+}
+} // namespace
+
+struct DriftFreeTimerTest : public testing::Test
+{
+protected:
+  void TearDown() override
+  {
+    NarrowStepper::terminate(false);
+    WideStepper::terminate(false);
+    NarrowStepper::reset();
+    WideStepper::reset();
+  }
+};
+
+// However late the handler runs, every step sits exactly where the programmed intervals put it.
+TEST_F(DriftFreeTimerTest, FullRampHasNoCumulativeDrift)
+{
+  runRamp<Wide, WideStepper>(1);
+
+  EXPECT_EQ(20000U, EventDriver<Wide>::times.size());
+  EXPECT_EQ(20000, WideStepper::getPosition());
+  expectNoDrift<Wide>();
+}
+
+TEST_F(DriftFreeTimerTest, StepsDoNotDependOnLatency)
+{
+  const std::vector<uint64_t> first = runRamp<Wide, WideStepper>(1);
+  const std::vector<uint64_t> second = runRamp<Wide, WideStepper>(0xC0FFEE);
+
+  EXPECT_EQ(first, second);
+}
+
+// A 32 bit counter needs exactly one update per step, also far below 244 steps/s.
+TEST_F(DriftFreeTimerTest, WideCounterNeedsNoOverflowInterrupts)
+{
+  Wide::reset();
+  Recorder<Wide>::reset();
+  EventDriver<Wide>::times.clear();
+
+  WideStepper::reset();
+  WideStepper::moveTo(20.0f, 200);
+  Wide::run(Jitter{7});
+
+  EXPECT_EQ(200, WideStepper::getPosition());
+  EXPECT_EQ(200U, Wide::updates);
+  expectNoDrift<Wide>();
+}
+
+// A 16 bit counter splits slow intervals into several periods, still without drift, and produces
+// the same steps as a 32 bit one.
+TEST_F(DriftFreeTimerTest, NarrowCounterSplitsSlowIntervals)
+{
+  Narrow::reset();
+  Recorder<Narrow>::reset();
+  EventDriver<Narrow>::times.clear();
+  Wide::reset();
+  Recorder<Wide>::reset();
+  EventDriver<Wide>::times.clear();
+
+  NarrowStepper::reset();
+  NarrowStepper::moveTo(20.0f, 200);
+  Narrow::run(Jitter{7});
+  WideStepper::reset();
+  WideStepper::moveTo(20.0f, 200);
+  Wide::run(Jitter{7});
+
+  EXPECT_EQ(200, NarrowStepper::getPosition());
+  EXPECT_GT(Narrow::updates, 200U * 10);
+  EXPECT_EQ(EventDriver<Wide>::times, EventDriver<Narrow>::times);
+  expectNoDrift<Narrow>();
+}
+
+// A handler that overran its own interval forces the update instead of letting the counter wrap.
+TEST_F(DriftFreeTimerTest, OverrunForcesUpdate)
+{
+  using Engine = Wide::Engine;
+  Wide::reset();
+
+  Engine::setInterval(1000);
+  EXPECT_EQ(1U, Wide::tim.CR1 & 1);
+  EXPECT_EQ(999U, Wide::tim.ARR);
+
+  Wide::tim.CNT = 1500;
+  Engine::setInterval(2000);
+  EXPECT_EQ(0U, Wide::tim.forced);
+  EXPECT_EQ(1999U, Wide::tim.ARR);
+
+  Engine::setInterval(200);
+  EXPECT_EQ(1U, Wide::tim.forced);
+  EXPECT_EQ(0U, Wide::tim.CNT);
+
+  Engine::stop();
+  EXPECT_EQ(0U, Wide::tim.CR1 & 1);
+}
+
+// Timers started while held stay halted with their first interval loaded until the group release.
+TEST_F(DriftFreeTimerTest, SyncStartReleasesHeldTimersTogether)
+{
+  using Launch = SyncStart<Narrow::Engine, Wide::Engine>;
+  Narrow::reset();
+  Wide::reset();
+
+  Launch::hold();
+  Narrow::Engine::setInterval(3000);
+  Wide::Engine::setInterval(5000);
+  EXPECT_EQ(0U, Narrow::tim.CR1 & 1);
+  EXPECT_EQ(0U, Wide::tim.CR1 & 1);
+  EXPECT_EQ(2999U, Narrow::tim.ARR);
+  EXPECT_EQ(4999U, Wide::tim.ARR);
+  EXPECT_EQ(0U, Narrow::tim.CNT);
+
+  Launch::release();
+  EXPECT_EQ(1U, Narrow::tim.CR1 & 1);
+  EXPECT_EQ(1U, Wide::tim.CR1 & 1);
+
+  // released, the next move starts right away again
+  Narrow::Engine::stop();
+  Narrow::Engine::setInterval(3000);
+  EXPECT_EQ(1U, Narrow::tim.CR1 & 1);
+
+  Narrow::Engine::stop();
+  Wide::Engine::stop();
+}
+
+// A timer that was stopped while held is not started by the release.
+TEST_F(DriftFreeTimerTest, SyncStartSkipsTimersStoppedWhileHeld)
+{
+  using Launch = SyncStart<Narrow::Engine, Wide::Engine>;
+  Narrow::reset();
+  Wide::reset();
+
+  Launch::hold();
+  Narrow::Engine::setInterval(3000);
+  Narrow::Engine::stop();
+  Launch::release();
+
+  EXPECT_EQ(0U, Narrow::tim.CR1 & 1);
+  EXPECT_EQ(0U, Wide::tim.CR1 & 1);
+}
+
+namespace
+{
+using Output = ModelSource<2, false>;
+using OutputPin = CompareOutputPin_STM32<Output, 0>;
+
+/// Driver on a compare output step pin that also records the update event of every step.
+struct OutputDriver
+{
+  constexpr static uint32_t SPR = 400 * 256;
+
+  static std::vector<uint64_t> times;
+
+  static void init()
+  {
+    OutputPin::init();
+  }
+
+  static void step()
+  {
+    times.push_back(Output::event);
+    OutputPin::pulse();
+  }
+
+  static void dir(bool)
+  {
+  }
+
+  static void setInverted(bool)
+  {
+  }
+};
+
+std::vector<uint64_t> OutputDriver::times;
+
+using OutputStepper = Stepper<Recorder<Output>, OutputDriver, Ramp>;
+
+void runOutput(const float speed, const int32_t target)
+{
+  Output::reset();
+  Recorder<Output>::reset();
+  OutputDriver::times.clear();
+
+  OutputStepper::reset();
+  OutputStepper::init();
+  OutputStepper::moveTo(speed, target);
+  Output::run(Jitter{5});
+}
+} // namespace
+
+// The compare channel raises the step pin at the update events that end an interval, the handler
+// only lowers it again.
+TEST_F(DriftFreeTimerTest, CompareOutputRaisesStepsAtUpdateEvents)
+{
+  runOutput(5000.0f, 2000);
+
+  EXPECT_EQ(2000, OutputStepper::getPosition());
+  // only the first step, the counter starts one past the match
+  EXPECT_EQ(1U, Recorder<Output>::misses);
+  EXPECT_EQ(OutputDriver::times, Output::tim.rising);
+  ASSERT_EQ(Output::tim.rising.size(), Output::tim.falling.size());
+  for (size_t i = 0; i < Output::tim.rising.size(); i++)
+  {
+    EXPECT_LT(Output::tim.rising[i], Output::tim.falling[i]);
+  }
+
+  EXPECT_EQ(static_cast<uint64_t>(Ramp::interval(1)) - 1, Output::tim.rising.front());
+  EXPECT_FALSE(Output::tim.oc1);
+
+  OutputStepper::terminate(false);
+  OutputStepper::reset();
+}
+
+// The intermediate periods of a split interval do not raise the step pin.
+TEST_F(DriftFreeTimerTest, CompareOutputSkipsSplitPeriods)
+{
+  runOutput(20.0f, 5);
+
+  EXPECT_EQ(5, OutputStepper::getPosition());
+  EXPECT_GT(Output::updates, 5U * 12U);
+  EXPECT_EQ(OutputDriver::times, Output::tim.rising);
+  EXPECT_EQ(5U, Output::tim.falling.size());
+
+  OutputStepper::terminate(false);
+  OutputStepper::reset();
+}
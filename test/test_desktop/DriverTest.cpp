@@ -1,8 +1,14 @@
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
+#include "gmocks/MockedDriver.h"
+#include "gmocks/MockedIntervalInterrupt.h"
 #include "gmocks/MockedPin.h"
 
+#include <vector>
+
 #include "Driver.h"
+#include "Pin.h"
+#include "Stepper.h"
 
 using namespace ::testing;
 
@@ -31,3 +37,121 @@ TEST_F(DriverTest, init)
     EXPECT_CALL(*PIN_DIR::mock, init()).Times(1);
     Driver<PIN_STEP, PIN_DIR>::init();
 }
+
+TEST_F(DriverTest, immediateStepPulses)
+{
+    EXPECT_CALL(*PIN_STEP::mock, pulse()).Times(1);
+    Driver<PIN_STEP, PIN_DIR>::step();
+    Driver<PIN_STEP, PIN_DIR>::release();
+}
+
+TEST_F(DriverTest, deferredStepOnlyRaises)
+{
+    using DeferredDriver = Driver<PIN_STEP, PIN_DIR, StepPulse::DEFERRED>;
+
+    InSequence sequence;
+    EXPECT_CALL(*PIN_STEP::mock, high()).Times(1);
+    EXPECT_CALL(*PIN_STEP::mock, low()).Times(1);
+    DeferredDriver::step();
+    DeferredDriver::release();
+}
+
+TEST_F(DriverTest, dualEdgeStepToggles)
+{
+    using DualEdgeDriver = Driver<PIN_STEP, PIN_DIR, StepPulse::DUAL_EDGE>;
+
+    InSequence sequence;
+    EXPECT_CALL(*PIN_STEP::mock, init()).Times(1);
+    EXPECT_CALL(*PIN_DIR::mock, init()).Times(1);
+    EXPECT_CALL(*PIN_STEP::mock, high()).Times(1);
+    EXPECT_CALL(*PIN_STEP::mock, low()).Times(1);
+    EXPECT_CALL(*PIN_STEP::mock, high()).Times(1);
+    DualEdgeDriver::init();
+    DualEdgeDriver::step();
+    DualEdgeDriver::step();
+    DualEdgeDriver::step();
+    DualEdgeDriver::release();
+}
+
+namespace
+{
+using DeferredStepPin = Pin<30>;
+using DeferredStepper = Stepper<MockedIntervalInterrupt<4>, Driver<DeferredStepPin, Pin<31>, StepPulse::DEFERRED>, AccelerationRamp<256, F_CPU, 40352, 40352>>;
+
+std::vector<bool> step_levels;
+
+void recordStepPin(uint8_t, const bool value)
+{
+    step_levels.push_back(value);
+}
+} // namespace
+
+// Through the Pin_Delegate backend: every step raises the pin once and the interrupt after it lowers
+// it again right before the next rise. The pin stays high after the last step of a move.
+TEST(DriverDeferredPulseTest, stepperLowersPinBeforeNextStep)
+{
+    MockedIntervalInterrupt<4>::mock = new NiceMock<IntervalInterruptMock>();
+    step_levels.clear();
+    PinDelegate<30>::delegate(etl::delegate<void(uint8_t, bool)>::create<recordStepPin>());
+
+    DeferredStepper::moveTo(8000.0f, 6000);
+    for (uint32_t i = 0; i < 2000 && MockedIntervalInterrupt<4>::mock->callback != nullptr; i++)
+    {
+        MockedIntervalInterrupt<4>::mock->callback();
+    }
+    MockedIntervalInterrupt<4>::mock->loopUntilStopped(UINT32_MAX);
+
+    ASSERT_EQ(2U * 6000, step_levels.size());
+    bool alternating = true;
+    for (size_t i = 0; i < step_levels.size(); i++)
+    {
+        alternating = alternating && (step_levels[i] == (i % 2 == 1));
+    }
+    EXPECT_TRUE(alternating);
+    EXPECT_TRUE(step_levels.back());
+    EXPECT_EQ(6000, DeferredStepper::getPosition());
+
+    PinDelegate<30>::delegate(etl::delegate<void(uint8_t, bool)>());
+    DeferredStepper::reset();
+    delete MockedIntervalInterrupt<4>::mock;
+}
+
+namespace
+{
+using DualEdgeDriver = MockedDriver<9, true>;
+using DualEdgeStepper = Stepper<MockedIntervalInterrupt<5>, DualEdgeDriver, AccelerationRamp<256, F_CPU, 40352, 40352>>;
+
+static_assert(DualEdgeStepper::DUAL_EDGE, "the capability of the driver is visible to the stepper");
+static_assert(!DeferredStepper::DUAL_EDGE, "drivers step on one edge by default");
+} // namespace
+
+// Every step is one toggle. Terminating between two steps leaves the pin at either level, and the
+// following move keeps toggling from there without losing or adding a step.
+TEST(DriverDualEdgeTest, stepperTogglesAcrossTermination)
+{
+    MockedIntervalInterrupt<5>::mock = new NiceMock<IntervalInterruptMock>();
+    DualEdgeDriver::mock = new NiceMock<DriverMock>();
+    DualEdgeDriver::position = 0;
+    DualEdgeDriver::level = false;
+
+    DualEdgeStepper::moveTo(8000.0f, 6000);
+    for (uint32_t i = 0; i < 2001 && MockedIntervalInterrupt<5>::mock->callback != nullptr; i++)
+    {
+        MockedIntervalInterrupt<5>::mock->callback();
+    }
+
+    DualEdgeStepper::terminate(false);
+    EXPECT_EQ(2001, DualEdgeStepper::getPosition());
+    EXPECT_EQ(2001, DualEdgeDriver::position);
+    EXPECT_TRUE(DualEdgeDriver::level);
+
+    DualEdgeStepper::moveTo(8000.0f, 0);
+    MockedIntervalInterrupt<5>::mock->loopUntilStopped(UINT32_MAX);
+    EXPECT_EQ(0, DualEdgeStepper::getPosition());
+    EXPECT_EQ(0, DualEdgeDriver::position);
+    EXPECT_FALSE(DualEdgeDriver::level);
+
+    DualEdgeStepper::reset();
+    delete DualEdgeDriver::mock;
+    delete MockedIntervalInterrupt<5>::mock;
+}
@@ -0,0 +1,207 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "DynamicRamp.h"
+#include "StepperTestSupport.h"
+
+namespace
+{
+constexpr uint16_t STAIRS = 256;
+constexpr uint8_t STEPS = 128;
+
+/// Shared desktop test limits expressed as a runtime ramp.
+using TestRamp = DynamicRamp<STAIRS, F_CPU, STEPS>;
+} // namespace
+
+struct DynamicRampTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    TestRamp::init(FAST_SPEED, FAST_ACCELERATION);
+  }
+};
+
+// Stair 0 is a sentinel value and must stay at the largest interval.
+TEST_F(DynamicRampTest, interval_0)
+{
+  ASSERT_EQ(TestRamp::interval(0), UINT32_MAX);
+}
+
+// Each higher stair represents a faster step rate, so intervals must not increase.
+TEST_F(DynamicRampTest, interval_decrementing)
+{
+  for (uint16_t i = 0; i < STAIRS - 1; i++)
+  {
+    ASSERT_LE(TestRamp::interval(i + 1), TestRamp::interval(i));
+  }
+}
+
+// No stair may exceed the configured maximum speed, including stairs above the top stair.
+TEST_F(DynamicRampTest, lessEqual_maxSpeed)
+{
+  for (uint16_t i = 0; i < STAIRS; i++)
+  {
+    ASSERT_GE(TestRamp::interval(i), static_cast<uint32_t>(F_CPU / FAST_SPEED));
+  }
+  ASSERT_EQ(TestRamp::getIntervalForSpeed(FAST_SPEED * 2), static_cast<uint32_t>(F_CPU / FAST_SPEED));
+}
+
+// Each stair runs at the average speed of a constant acceleration over that stair, which is its
+// length divided by the time difference of t = sqrt(2 * s / a) at both ends.
+TEST_F(DynamicRampTest, intervals_follow_configured_acceleration)
+{
+  for (uint16_t i = 1; i < TestRamp::maxAccelStairs(FAST_SPEED); i++)
+  {
+    const float speed = static_cast<float>(F_CPU) / static_cast<float>(TestRamp::interval(i));
+    const float expected = std::sqrt(FAST_ACCELERATION * STEPS / 2.0f) *
+                           (std::sqrt(static_cast<float>(i + 1)) + std::sqrt(static_cast<float>(i)));
+
+    ASSERT_NEAR(expected, speed, expected * 0.005f) << "stair " << i;
+  }
+}
+
+// Zero speed stays idle, the maximum speed lands on the top stair of the configured profile.
+TEST_F(DynamicRampTest, maxAccelStairs_limits)
+{
+  const auto top_stair = static_cast<uint16_t>(FAST_SPEED * FAST_SPEED / (2.0f * FAST_ACCELERATION * STEPS));
+
+  ASSERT_EQ(0, TestRamp::maxAccelStairs(0.0f));
+  ASSERT_EQ(top_stair, TestRamp::maxAccelStairs(FAST_SPEED));
+  ASSERT_EQ(top_stair, TestRamp::maxAccelStairs(-FAST_SPEED * 2));
+  ASSERT_EQ(top_stair / 4, TestRamp::maxAccelStairs(FAST_SPEED / 2));
+}
+
+// Speeds beyond what the table can hold are capped at its last stair.
+TEST_F(DynamicRampTest, maxAccelStairs_capped_by_table)
+{
+  TestRamp::init(FAST_SPEED * 4, FAST_ACCELERATION);
+
+  ASSERT_EQ(STAIRS - 1, TestRamp::maxAccelStairs(FAST_SPEED * 4));
+}
+
+// The rebuild is spread over several calls and only becomes visible through `swap()`.
+TEST_F(DynamicRampTest, incremental_rebuild_and_swap)
+{
+  const uint32_t old_top = TestRamp::interval(STAIRS - 1);
+  const uint16_t old_stairs = TestRamp::maxAccelStairs(FAST_SPEED / 2);
+
+  TestRamp::configure(FAST_SPEED / 2, FAST_ACCELERATION / 4);
+  EXPECT_FALSE(TestRamp::swap());
+
+  int calls = 1;
+  while (!TestRamp::rebuild(16))
+  {
+    calls++;
+    EXPECT_FALSE(TestRamp::ready());
+    EXPECT_EQ(old_top, TestRamp::interval(STAIRS - 1));
+    EXPECT_EQ(old_stairs, TestRamp::maxAccelStairs(FAST_SPEED / 2));
+  }
+  EXPECT_EQ((STAIRS - 1 + 15) / 16, calls);
+
+  ASSERT_TRUE(TestRamp::swap());
+  EXPECT_FLOAT_EQ(FAST_SPEED / 2, TestRamp::maxSpeed());
+  EXPECT_FLOAT_EQ(FAST_ACCELERATION / 4, TestRamp::acceleration());
+  EXPECT_EQ(static_cast<uint32_t>(F_CPU / (FAST_SPEED / 2)), TestRamp::interval(STAIRS - 1));
+
+  // the previous table has to be rebuilt before it can be swapped in again
+  EXPECT_FALSE(TestRamp::rebuild(STAIRS));
+  EXPECT_FALSE(TestRamp::swap());
+}
+
+// A table built incrementally is identical to one built in a single call.
+TEST_F(DynamicRampTest, incremental_rebuild_matches_init)
+{
+  uint32_t expected[STAIRS];
+
+  TestRamp::init(FAST_SPEED / 3, FAST_ACCELERATION * 2);
+  for (uint16_t i = 0; i < STAIRS; i++)
+  {
+    expected[i] = TestRamp::interval(i);
+  }
+
+  TestRamp::init(FAST_SPEED, FAST_ACCELERATION);
+  TestRamp::configure(FAST_SPEED / 3, FAST_ACCELERATION * 2);
+  while (!TestRamp::rebuild(7))
+  {
+  }
+  ASSERT_TRUE(TestRamp::swap());
+
+  for (uint16_t i = 0; i < STAIRS; i++)
+  {
+    ASSERT_EQ(expected[i], TestRamp::interval(i)) << "stair " << i;
+  }
+}
+
+/// Stepper driven by a runtime-configurable ramp.
+using DynamicStepper = Stepper<Interrupt, Driver, DynamicRamp<STAIRS, F_CPU, STEPS, 1>>;
+
+struct DynamicStepperTest : public StepperBehaviorTestBase
+{
+protected:
+  void TearDown() override
+  {
+    DynamicStepper::reset();
+    StepperBehaviorTestBase::TearDown();
+  }
+};
+
+// The dynamic ramp is a drop-in replacement and can be reconfigured between moves.
+TEST_F(DynamicStepperTest, MovesWithReconfiguredLimits)
+{
+  using DynamicStepperRamp = DynamicRamp<STAIRS, F_CPU, STEPS, 1>;
+
+  EXPECT_CALL(*Interrupt::mock, stop()).Times(::testing::AnyNumber());
+  EXPECT_CALL(*Interrupt::mock, setInterval(::testing::_)).Times(::testing::AnyNumber());
+  EXPECT_CALL(*Driver::mock, step()).Times(::testing::AnyNumber());
+  EXPECT_CALL(*Driver::mock, dir(::testing::_)).Times(::testing::AnyNumber());
+
+  DynamicStepperRamp::init(FAST_SPEED, FAST_ACCELERATION);
+
+  DynamicStepper::moveBy(FAST_SPEED, 50000);
+  Interrupt::loopUntilStopped(UINT32_MAX);
+  EXPECT_EQ(50000, Driver::position);
+
+  DynamicStepperRamp::configure(FAST_SPEED / 2, FAST_ACCELERATION / 2);
+  while (!DynamicStepperRamp::rebuild(32))
+  {
+  }
+  ASSERT_TRUE(DynamicStepperRamp::swap());
+
+  DynamicStepper::moveTo(FAST_SPEED, 0);
+  Interrupt::loopUntilStopped(UINT32_MAX);
+  EXPECT_EQ(0, Driver::position);
+  EXPECT_EQ(0, DynamicStepper::getPosition());
+  EXPECT_FALSE(DynamicStepper::isRunning());
+}
+
+// A table is only swapped in while no move runs on it, a running move keeps its table to the end.
+TEST_F(DynamicStepperTest, SwapIsRefusedWhileMoving)
+{
+  using DynamicStepperRamp = DynamicRamp<STAIRS, F_CPU, STEPS, 1>;
+
+  EXPECT_CALL(*Interrupt::mock, stop()).Times(::testing::AnyNumber());
+  EXPECT_CALL(*Interrupt::mock, setInterval(::testing::_)).Times(::testing::AnyNumber());
+  EXPECT_CALL(*Driver::mock, step()).Times(::testing::AnyNumber());
+  EXPECT_CALL(*Driver::mock, dir(::testing::_)).Times(::testing::AnyNumber());
+
+  DynamicStepperRamp::init(FAST_SPEED, FAST_ACCELERATION);
+  const uint32_t top = DynamicStepperRamp::interval(STAIRS - 1);
+
+  DynamicStepper::moveBy(FAST_SPEED, 50000);
+  Interrupt::loopUntilStopped(1000, false);
+
+  DynamicStepperRamp::configure(FAST_SPEED / 2, FAST_ACCELERATION / 2);
+  while (!DynamicStepperRamp::rebuild(32))
+  {
+  }
+  EXPECT_FALSE(DynamicStepperRamp::swap());
+  EXPECT_EQ(top, DynamicStepperRamp::interval(STAIRS - 1));
+
+  Interrupt::loopUntilStopped(UINT32_MAX);
+  EXPECT_EQ(50000, Driver::position);
+
+  ASSERT_TRUE(DynamicStepperRamp::swap());
+  EXPECT_FLOAT_EQ(FAST_SPEED / 2, DynamicStepperRamp::maxSpeed());
+}
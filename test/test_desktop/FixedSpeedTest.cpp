@@ -0,0 +1,184 @@
+#include <cmath>
+#include <cstdlib>
+
+#include "DynamicRamp.h"
+#include "SCurveRamp.h"
+#include "StepperTestSupport.h"
+
+using ::testing::_;
+using ::testing::AnyNumber;
+
+namespace
+{
+using RealRamp = Ramp::REAL_TYPE;
+
+/// Speeds spread over the whole range of the shared test profile, in millisteps per second.
+constexpr int32_t TEST_SPEEDS_MILLI[] = {1, 999, 42149, 1000000, 4321987, 20176278, 40352557, 80000000};
+} // namespace
+
+TEST(FixedSpeedTest, Factories)
+{
+  EXPECT_EQ(1500, FixedSpeed::milli(1500).milli());
+  EXPECT_EQ(-42000, FixedSpeed::sps(-42).milli());
+  EXPECT_EQ(42000, (-FixedSpeed::sps(-42)).milli());
+  EXPECT_EQ(0, FixedSpeed().milli());
+
+  EXPECT_TRUE(FixedSpeed::milli(-1).isNegative());
+  EXPECT_FALSE(FixedSpeed::milli(0).isNegative());
+  EXPECT_EQ(static_cast<uint32_t>(INT32_MAX) + 1U, FixedSpeed::milli(INT32_MIN).absMilli());
+}
+
+// The integer interval stays within one timer tick of the exact quotient.
+TEST(FixedSpeedTest, IntervalMatchesExactQuotient)
+{
+  for (const int32_t milli : TEST_SPEEDS_MILLI)
+  {
+    const auto exact = static_cast<int64_t>(static_cast<double>(F_CPU) * 1000.0 / milli);
+    const int64_t expected = (exact > UINT32_MAX) ? UINT32_MAX : exact;
+
+    EXPECT_LE(std::llabs(expected - RealRamp::getIntervalForSpeed(FixedSpeed::milli(milli))), 1) << milli;
+    EXPECT_LE(std::llabs(expected - RealRamp::getIntervalForSpeed(FixedSpeed::milli(-milli))), 1) << milli;
+  }
+}
+
+// The division is exact, so it is at least as precise as the float path.
+TEST(FixedSpeedTest, IntervalMatchesFloat)
+{
+  for (const int32_t milli : {42149, 1000000, 4321987, 40352557})
+  {
+    const auto expected = static_cast<int64_t>(RealRamp::getIntervalForSpeed(static_cast<float>(milli) / 1000.0f));
+
+    EXPECT_LE(std::llabs(expected - RealRamp::getIntervalForSpeed(FixedSpeed::milli(milli))), 1) << milli;
+  }
+}
+
+TEST(FixedSpeedTest, IntervalOfZeroSpeedSaturates)
+{
+  EXPECT_EQ(UINT32_MAX, FixedSpeed().interval<F_CPU>());
+  EXPECT_EQ(UINT32_MAX, FixedSpeed::milli(1).interval<F_CPU>());
+}
+
+// Steps within a time window round exactly like the 64-bit formula.
+TEST(FixedSpeedTest, StepsInMatchesWideFormula)
+{
+  constexpr uint32_t TIMES_MS[] = {0, 1, 999, 1000, 1001, 123456, 3600000};
+
+  for (const int32_t milli : TEST_SPEEDS_MILLI)
+  {
+    for (const uint32_t time_ms : TIMES_MS)
+    {
+      const auto expected = static_cast<int32_t>(static_cast<int64_t>(milli) * time_ms / 1000000);
+
+      EXPECT_EQ(expected, FixedSpeed::milli(milli).stepsIn(time_ms)) << milli << " " << time_ms;
+      EXPECT_EQ(-expected, FixedSpeed::milli(-milli).stepsIn(time_ms)) << milli << " " << time_ms;
+    }
+  }
+}
+
+// The stair lookup returns the highest stair that is not faster than the requested interval and
+// differs from the float formula by at most one stair.
+TEST(FixedSpeedTest, StairForIntervalIsHighestNotFasterStair)
+{
+  for (const int32_t milli : TEST_SPEEDS_MILLI)
+  {
+    const uint32_t interval = RealRamp::getIntervalForSpeed(FixedSpeed::milli(milli));
+    const uint16_t stair = RealRamp::maxAccelStairsForInterval(interval);
+
+    EXPECT_GE(RealRamp::interval(stair), interval) << milli;
+    if (stair < RealRamp::STAIRS_COUNT - 1)
+    {
+      EXPECT_LT(RealRamp::interval(stair + 1), interval) << milli;
+    }
+
+    const uint16_t float_stair = RealRamp::maxAccelStairs(static_cast<float>(milli) / 1000.0f);
+    EXPECT_LE(std::abs(static_cast<int>(float_stair) - static_cast<int>(stair)), 1) << milli;
+  }
+}
+
+// Every ramp type provides the integer lookups.
+TEST(FixedSpeedTest, OtherRampTypes)
+{
+  using SCurve = SCurveRamp<256, F_CPU, 40352, 40352, 161410>;
+  using Dynamic = DynamicRamp<256, F_CPU, 128, 2>;
+  Dynamic::init(FAST_SPEED, FAST_ACCELERATION);
+
+  const FixedSpeed fast = FixedSpeed::milli(40352557);
+  const FixedSpeed half = FixedSpeed::milli(20176278);
+
+  EXPECT_EQ(SCurve::STAIRS_COUNT - 1, SCurve::maxAccelStairsForInterval(SCurve::getIntervalForSpeed(fast)));
+  EXPECT_EQ(SCurve::maxAccelStairs(20176.278f), SCurve::maxAccelStairsForInterval(SCurve::getIntervalForSpeed(half)));
+
+  EXPECT_EQ(Dynamic::maxAccelStairs(FAST_SPEED), Dynamic::maxAccelStairsForInterval(Dynamic::getIntervalForSpeed(fast)));
+  EXPECT_EQ(Dynamic::getIntervalForSpeed(fast), Dynamic::getIntervalForSpeed(FixedSpeed::sps(1000000)));
+
+  EXPECT_EQ(0, ConstantRamp<F_CPU>::maxAccelStairsForInterval(400));
+  EXPECT_EQ(ConstantRamp<F_CPU>::getIntervalForSpeed(1000.0f), ConstantRamp<F_CPU>::getIntervalForSpeed(FixedSpeed::sps(1000)));
+}
+
+struct StepperFixedSpeedTest : public StepperBehaviorTestBase
+{
+protected:
+  void SetUp() override
+  {
+    StepperBehaviorTestBase::SetUp();
+
+    EXPECT_CALL(*Interrupt::mock, stop()).Times(AnyNumber());
+    EXPECT_CALL(*Interrupt::mock, setInterval(_)).Times(AnyNumber());
+    EXPECT_CALL(*Driver::mock, step()).Times(AnyNumber());
+    EXPECT_CALL(*Driver::mock, dir(_)).Times(AnyNumber());
+  }
+};
+
+TEST_F(StepperFixedSpeedTest, MovementSpecMatchesFloatSpec)
+{
+  const auto fixed = TestStepper::MovementSpec::distance(-FixedSpeed::milli(20176278), 5000);
+  const auto real = TestStepper::MovementSpec::distance(-20176.278f, 5000);
+
+  EXPECT_EQ(real.steps, fixed.steps);
+  EXPECT_NEAR(real.run_interval, fixed.run_interval, 1);
+  EXPECT_NEAR(real.accel_stair, fixed.accel_stair, 1);
+
+  const auto timed = TestStepper::MovementSpec::time(FixedSpeed::milli(1500), 2500);
+  EXPECT_EQ(3, timed.steps);
+  EXPECT_EQ(0, timed.accel_stair);
+}
+
+TEST_F(StepperFixedSpeedTest, MovesReachTheirTargets)
+{
+  const FixedSpeed fast = FixedSpeed::milli(40352557);
+
+  TestStepper::moveBy(fast, 100000);
+  runInterruptSteps(UINT32_MAX);
+  expectIdleState(100000);
+
+  TestStepper::moveTo(-fast, -5000);
+  runInterruptSteps(UINT32_MAX);
+  expectIdleState(-5000);
+
+  TestStepper::moveTime(FixedSpeed::sps(-1000), 1500);
+  runInterruptSteps(UINT32_MAX);
+  expectIdleState(-6500);
+
+  TestStepper::move(FixedSpeed::milli(20176278));
+  runInterruptSteps(10000, false);
+  TestStepper::stop();
+  runInterruptSteps(UINT32_MAX);
+  EXPECT_FALSE(TestStepper::isRunning());
+  EXPECT_GT(TestStepper::getPosition(), 3500);
+}
+
+// The fractional tick matches the exact quotient to the 1/65536 resolution.
+TEST(FixedSpeedTest, IntervalFractionMatchesExactQuotient)
+{
+  for (const int32_t milli : {999, 42149, 1000000, 4321987, 12000500})
+  {
+    const double exact = static_cast<double>(F_CPU) * 1000.0 / milli;
+    const double fraction = (exact - std::floor(exact)) * 65536.0;
+
+    EXPECT_NEAR(fraction, FixedSpeed::milli(milli).intervalFraction<F_CPU>(), 1.0) << milli;
+  }
+
+  EXPECT_EQ(0, FixedSpeed().intervalFraction<F_CPU>());
+  EXPECT_EQ(0, FixedSpeed::sps(1000).intervalFraction<F_CPU>());
+  EXPECT_EQ(0, FixedSpeed::milli(1).intervalFraction<F_CPU>());
+}
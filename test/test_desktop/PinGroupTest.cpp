@@ -0,0 +1,156 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "gmocks/MockedIntervalInterrupt.h"
+#include "gmocks/MockedPin.h"
+
+#include <utility>
+#include <vector>
+
+#include "DriverGroup.h"
+#include "Pin.h"
+#include "PinGroup.h"
+#include "Stepper.h"
+
+using namespace ::testing;
+
+using LEFT_STEP = MockedPin<2>;
+using LEFT_DIR = MockedPin<3>;
+using RIGHT_STEP = MockedPin<4>;
+using RIGHT_DIR = MockedPin<5>;
+
+class PinGroupTest : public Test
+{
+protected:
+    void SetUp() override
+    {
+        LEFT_STEP::mock = new StrictMock<PinMock>();
+        LEFT_DIR::mock = new StrictMock<PinMock>();
+        RIGHT_STEP::mock = new StrictMock<PinMock>();
+        RIGHT_DIR::mock = new StrictMock<PinMock>();
+    }
+
+    void TearDown() override
+    {
+        delete LEFT_STEP::mock;
+        delete LEFT_DIR::mock;
+        delete RIGHT_STEP::mock;
+        delete RIGHT_DIR::mock;
+    }
+};
+
+TEST_F(PinGroupTest, initAndLevelsReachEveryPin)
+{
+    using Group = PinGroup<LEFT_STEP, RIGHT_STEP>;
+
+    InSequence sequence;
+    EXPECT_CALL(*LEFT_STEP::mock, init()).Times(1);
+    EXPECT_CALL(*RIGHT_STEP::mock, init()).Times(1);
+    EXPECT_CALL(*LEFT_STEP::mock, high()).Times(1);
+    EXPECT_CALL(*RIGHT_STEP::mock, high()).Times(1);
+    EXPECT_CALL(*LEFT_STEP::mock, low()).Times(1);
+    EXPECT_CALL(*RIGHT_STEP::mock, low()).Times(1);
+    Group::init();
+    Group::high();
+    Group::low();
+}
+
+// The pulses overlap: no pin goes low before all of them are high.
+TEST_F(PinGroupTest, pulseRaisesAllBeforeLowering)
+{
+    InSequence sequence;
+    EXPECT_CALL(*LEFT_STEP::mock, high()).Times(1);
+    EXPECT_CALL(*RIGHT_STEP::mock, high()).Times(1);
+    EXPECT_CALL(*LEFT_STEP::mock, low()).Times(1);
+    EXPECT_CALL(*RIGHT_STEP::mock, low()).Times(1);
+    PinGroup<LEFT_STEP, RIGHT_STEP>::pulse();
+}
+
+TEST_F(PinGroupTest, driverGroupStepsAllDrivers)
+{
+    using Gantry = DriverGroup<Driver<LEFT_STEP, LEFT_DIR>, Driver<RIGHT_STEP, RIGHT_DIR>>;
+
+    InSequence sequence;
+    EXPECT_CALL(*LEFT_STEP::mock, high()).Times(1);
+    EXPECT_CALL(*RIGHT_STEP::mock, high()).Times(1);
+    EXPECT_CALL(*LEFT_STEP::mock, low()).Times(1);
+    EXPECT_CALL(*RIGHT_STEP::mock, low()).Times(1);
+    Gantry::step();
+    Gantry::release();
+}
+
+TEST_F(PinGroupTest, driverGroupDeferredStepOnlyRaises)
+{
+    using Gantry = DriverGroup<Driver<LEFT_STEP, LEFT_DIR, StepPulse::DEFERRED>, Driver<RIGHT_STEP, RIGHT_DIR, StepPulse::DEFERRED>>;
+    static_assert(Gantry::DEFERRED_PULSE, "the pulse mode of the drivers applies to the group");
+
+    InSequence sequence;
+    EXPECT_CALL(*LEFT_STEP::mock, high()).Times(1);
+    EXPECT_CALL(*RIGHT_STEP::mock, high()).Times(1);
+    EXPECT_CALL(*LEFT_STEP::mock, low()).Times(1);
+    EXPECT_CALL(*RIGHT_STEP::mock, low()).Times(1);
+    Gantry::step();
+    Gantry::release();
+}
+
+// A mirrored motor keeps its own inversion, so both motors of the axis turn the same way.
+TEST_F(PinGroupTest, driverGroupDirHonoursEachInversion)
+{
+    using Left = Driver<LEFT_STEP, LEFT_DIR>;
+    using Right = Driver<RIGHT_STEP, RIGHT_DIR>;
+    using Gantry = DriverGroup<Left, Right>;
+
+    Right::setInverted(true);
+
+    InSequence sequence;
+    EXPECT_CALL(*LEFT_DIR::mock, high()).Times(1);
+    EXPECT_CALL(*RIGHT_DIR::mock, low()).Times(1);
+    EXPECT_CALL(*LEFT_DIR::mock, low()).Times(1);
+    EXPECT_CALL(*RIGHT_DIR::mock, high()).Times(1);
+    Gantry::dir(true);
+    Gantry::dir(false);
+
+    Right::setInverted(false);
+}
+
+namespace
+{
+using GantryStepper = Stepper<MockedIntervalInterrupt<6>, DriverGroup<Driver<Pin<40>, Pin<41>>, Driver<Pin<42>, Pin<43>>>, AccelerationRamp<256, F_CPU, 40352, 40352>>;
+
+std::vector<std::pair<uint8_t, bool>> step_writes;
+
+void recordStepPin(const uint8_t pin, const bool value)
+{
+    step_writes.emplace_back(pin, value);
+}
+} // namespace
+
+// Through the Pin_Delegate backend: one stepper moves both motors of the axis, every step pulses
+// both step pins with overlapping pulses, also in the run blocks.
+TEST(DriverGroupStepperTest, gantryMovesBothMotors)
+{
+    MockedIntervalInterrupt<6>::mock = new NiceMock<IntervalInterruptMock>();
+    step_writes.clear();
+    PinDelegate<40>::delegate(etl::delegate<void(uint8_t, bool)>::create<recordStepPin>());
+    PinDelegate<42>::delegate(etl::delegate<void(uint8_t, bool)>::create<recordStepPin>());
+
+    GantryStepper::moveTo(20000.0f, 6000);
+    MockedIntervalInterrupt<6>::mock->loopUntilStopped(UINT32_MAX);
+
+    ASSERT_EQ(4U * 6000, step_writes.size());
+    bool overlapping = true;
+    for (size_t i = 0; i < step_writes.size(); i += 4)
+    {
+        overlapping = overlapping &&
+                      step_writes[i] == std::make_pair(uint8_t{40}, true) &&
+                      step_writes[i + 1] == std::make_pair(uint8_t{42}, true) &&
+                      step_writes[i + 2] == std::make_pair(uint8_t{40}, false) &&
+                      step_writes[i + 3] == std::make_pair(uint8_t{42}, false);
+    }
+    EXPECT_TRUE(overlapping);
+    EXPECT_EQ(6000, GantryStepper::getPosition());
+
+    PinDelegate<40>::delegate(etl::delegate<void(uint8_t, bool)>());
+    PinDelegate<42>::delegate(etl::delegate<void(uint8_t, bool)>());
+    GantryStepper::reset();
+    delete MockedIntervalInterrupt<6>::mock;
+}
@@ -0,0 +1,149 @@
+#include "PinRegisters.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+/// Register model of an STM32 GPIO port: BSRR writes are recorded and applied to ODR.
+struct ModelGpio
+{
+  struct SetReset
+  {
+    ModelGpio *gpio;
+
+    SetReset &operator=(const uint32_t value)
+    {
+      gpio->writes.push_back(value);
+      // set wins over reset for the same bit
+      gpio->ODR = (gpio->ODR & ~(value >> 16)) | (value & 0xFFFF);
+      return *this;
+    }
+  };
+
+  SetReset BSRR{this};
+  uint32_t ODR = 0;
+  std::vector<uint32_t> writes;
+};
+
+ModelGpio gpio_a;
+ModelGpio gpio_b;
+
+/// Pins 0 to 15 are PA0 to PA15, pins 16 to 31 are PB0 to PB15.
+struct ModelGpioBank
+{
+  using Gpio = ModelGpio;
+
+  static Gpio *port(const uint8_t pin)
+  {
+    return pin < 16 ? &gpio_a : &gpio_b;
+  }
+
+  static uint32_t mask(const uint8_t pin)
+  {
+    return 1UL << (pin % 16);
+  }
+};
+
+/// Register model of a SAMD port group: OUTSET and OUTCLR writes are recorded and applied to OUT.
+struct ModelPortGroup
+{
+  struct Strobe
+  {
+    ModelPortGroup *group;
+    bool set;
+
+    Strobe &operator=(const uint32_t value)
+    {
+      group->writes.push_back(value);
+      group->OUT = set ? (group->OUT | value) : (group->OUT & ~value);
+      return *this;
+    }
+  };
+
+  struct Register
+  {
+    Strobe reg;
+  };
+
+  Register OUTSET{{this, true}};
+  Register OUTCLR{{this, false}};
+  uint32_t OUT = 0;
+  std::vector<uint32_t> writes;
+};
+
+ModelPortGroup group_a;
+
+struct ModelPortBank
+{
+  using Group = ModelPortGroup;
+
+  static Group *port(uint8_t)
+  {
+    return &group_a;
+  }
+
+  static uint32_t mask(const uint8_t pin)
+  {
+    return 1UL << pin;
+  }
+};
+} // namespace
+
+struct PinRegistersTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    gpio_a.ODR = 0;
+    gpio_a.writes.clear();
+    gpio_b.ODR = 0;
+    gpio_b.writes.clear();
+    group_a.OUT = 0;
+    group_a.writes.clear();
+  }
+};
+
+// Every level change is a single BSRR store on the pin's own port, set in the low half and reset in
+// the high half.
+TEST_F(PinRegistersTest, BsrrWritesOneStorePerLevel)
+{
+  using pin = internal::BsrrPin<21, ModelGpioBank>;
+
+  pin::high();
+  EXPECT_EQ(1UL << 5, gpio_b.ODR);
+  pin::low();
+  EXPECT_EQ(0UL, gpio_b.ODR);
+
+  EXPECT_EQ((std::vector<uint32_t>{1UL << 5, 1UL << 21}), gpio_b.writes);
+  EXPECT_TRUE(gpio_a.writes.empty());
+}
+
+// Other pins of the port keep their level, without the pin ever reading the port.
+TEST_F(PinRegistersTest, BsrrLeavesOtherPinsAlone)
+{
+  using first = internal::BsrrPin<3, ModelGpioBank>;
+  using second = internal::BsrrPin<15, ModelGpioBank>;
+
+  gpio_a.ODR = 0x0F00;
+  first::high();
+  second::high();
+  first::low();
+  EXPECT_EQ(0x8F00UL, gpio_a.ODR);
+}
+
+TEST_F(PinRegistersTest, SetClearWritesOneStorePerLevel)
+{
+  using first = internal::SetClearPin<7, ModelPortBank>;
+  using second = internal::SetClearPin<30, ModelPortBank>;
+
+  group_a.OUT = 0x0000F000;
+  first::high();
+  second::high();
+  EXPECT_EQ(0x4000F080UL, group_a.OUT);
+  first::low();
+  EXPECT_EQ(0x4000F000UL, group_a.OUT);
+
+  EXPECT_EQ((std::vector<uint32_t>{1UL << 7, 1UL << 30, 1UL << 7}), group_a.writes);
+}
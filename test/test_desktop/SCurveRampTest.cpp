@@ -0,0 +1,184 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "SCurveRamp.h"
+#include "StepperTestSupport.h"
+
+#define TRANSMISSION 256.0f
+#define SPR 360
+#define DEG_TO_STEPS(d) static_cast<uint32_t>((d / 360.f) * SPR * TRANSMISSION)
+
+template<
+        uint16_t T_RAMP_STAIRS,
+        uint32_t T_MAX_SPEED,
+        uint32_t T_ACCELERATION,
+        uint32_t T_JERK
+>
+struct SCurveFixtureParams {
+    static constexpr uint16_t RAMP_STAIRS = T_RAMP_STAIRS;
+    static constexpr uint32_t MAX_SPEED = T_MAX_SPEED;
+    static constexpr uint32_t ACCELERATION = T_ACCELERATION;
+    static constexpr uint32_t JERK = T_JERK;
+};
+
+template<typename PARAMS>
+class SCurveRampTest : public ::testing::Test {
+protected:
+    void SetUp() override {}
+
+public:
+    using Ramp = SCurveRamp<PARAMS::RAMP_STAIRS, F_CPU, PARAMS::MAX_SPEED, PARAMS::ACCELERATION, PARAMS::JERK>;
+
+    const uint16_t RAMP_STAIRS = PARAMS::RAMP_STAIRS;
+    const uint32_t MAX_SPEED = PARAMS::MAX_SPEED;
+    const uint32_t ACCELERATION = PARAMS::ACCELERATION;
+
+    /// Average speed on a stair as it is executed by the stepper.
+    static float speed(const uint16_t stair) {
+        return static_cast<float>(F_CPU) / static_cast<float>(Ramp::interval(stair));
+    }
+
+    /// Time the ideal profile spends on a stair.
+    static float duration(const uint16_t stair) {
+        return Ramp::STEPS_PER_STAIR_IDEAL / speed(stair);
+    }
+
+    /// Speed error caused by truncating an interval to whole timer ticks.
+    static float quantization(const uint16_t stair) {
+        return speed(stair) / static_cast<float>(Ramp::interval(stair));
+    }
+};
+
+using SCurveTestTypes = ::testing::Types<
+        // jerk limited profile with a constant acceleration phase
+        SCurveFixtureParams<32, DEG_TO_STEPS(4), DEG_TO_STEPS(4), DEG_TO_STEPS(16)>,
+        SCurveFixtureParams<64, DEG_TO_STEPS(4), DEG_TO_STEPS(4), DEG_TO_STEPS(16)>,
+        SCurveFixtureParams<256, DEG_TO_STEPS(4), DEG_TO_STEPS(4), DEG_TO_STEPS(16)>,
+        // jerk too low to ever reach the configured acceleration
+        SCurveFixtureParams<32, DEG_TO_STEPS(4), DEG_TO_STEPS(4), DEG_TO_STEPS(4)>,
+        SCurveFixtureParams<128, DEG_TO_STEPS(4), DEG_TO_STEPS(4), DEG_TO_STEPS(4)>
+>;
+
+TYPED_TEST_SUITE(SCurveRampTest, SCurveTestTypes);
+
+// Stair 0 is a sentinel value and must stay at the largest interval.
+TYPED_TEST(SCurveRampTest, interval_0) {
+    ASSERT_EQ(TestFixture::Ramp::interval(0), UINT32_MAX);
+}
+
+// Each higher stair represents a faster step rate, so intervals must not increase.
+TYPED_TEST(SCurveRampTest, interval_decrementing) {
+    for (size_t i = 0; i < TestFixture::Ramp::STAIRS_COUNT - 1; i++) {
+        ASSERT_LE(TestFixture::Ramp::interval(i + 1), TestFixture::Ramp::interval(i));
+    }
+}
+
+// No computed stair may exceed the configured maximum speed interval.
+TYPED_TEST(SCurveRampTest, lessEqual_maxSpeed) {
+    for (size_t i = 0; i < TestFixture::Ramp::STAIRS_COUNT; i++) {
+        ASSERT_GE(TestFixture::Ramp::interval(i), F_CPU / TestFixture::MAX_SPEED);
+    }
+}
+
+// The template parameter must be reflected exactly in the generated ramp.
+TYPED_TEST(SCurveRampTest, STAIRS_COUNT) {
+    ASSERT_EQ(TestFixture::Ramp::STAIRS_COUNT, this->RAMP_STAIRS);
+}
+
+// Neighbouring stairs may only differ by what the configured acceleration allows within their
+// duration, so the velocity has no jumps anywhere on the ramp.
+TYPED_TEST(SCurveRampTest, velocity_continuous) {
+    const float acceleration = static_cast<float>(this->ACCELERATION);
+
+    for (uint16_t i = 1; i < this->RAMP_STAIRS - 1; i++) {
+        const float dv = TestFixture::speed(i + 1) - TestFixture::speed(i);
+        const float dt = 0.5f * (TestFixture::duration(i) + TestFixture::duration(i + 1));
+        const float tolerance = TestFixture::quantization(i) + TestFixture::quantization(i + 1);
+
+        ASSERT_LE(dv, acceleration * dt * 1.05f + tolerance) << "stair " << i;
+    }
+}
+
+// Since acceleration builds up gradually, the ramp is never faster than a constant-acceleration
+// ramp over the same distance.
+TYPED_TEST(SCurveRampTest, slower_than_constant_acceleration) {
+    for (uint16_t i = 1; i < this->RAMP_STAIRS; i++) {
+        const float distance = TestFixture::Ramp::STEPS_PER_STAIR_IDEAL * static_cast<float>(i + 1);
+        const float limit = std::sqrt(2.0f * static_cast<float>(this->ACCELERATION) * distance);
+
+        ASSERT_LE(TestFixture::speed(i), limit + TestFixture::quantization(i)) << "stair " << i;
+    }
+}
+
+// Towards the maximum speed the acceleration fades out instead of stopping abruptly.
+TYPED_TEST(SCurveRampTest, acceleration_fades_out_at_max_speed) {
+    const uint16_t last = this->RAMP_STAIRS - 1;
+    const float dv = TestFixture::speed(last) - TestFixture::speed(last - 1);
+    const float dt = 0.5f * (TestFixture::duration(last) + TestFixture::duration(last - 1));
+    const float tolerance = TestFixture::quantization(last) + TestFixture::quantization(last - 1);
+
+    ASSERT_LE(dv - tolerance, 0.25f * static_cast<float>(this->ACCELERATION) * dt);
+}
+
+// Zero speed must stay on the idle stair.
+TYPED_TEST(SCurveRampTest, maxAccelSteps_speed_0) {
+    ASSERT_EQ(TestFixture::Ramp::maxAccelStairs(0.0f), 0);
+}
+
+// Asking for the configured maximum speed must land on the top valid stair.
+TYPED_TEST(SCurveRampTest, maxAccelSteps_speed_max) {
+    ASSERT_EQ(TestFixture::Ramp::maxAccelStairs(this->MAX_SPEED), this->RAMP_STAIRS - 1);
+}
+
+// The speed implied by each stair interval must map back to a stair with that same interval for
+// both positive acceleration and negative deceleration.
+TYPED_TEST(SCurveRampTest, interval_speed_maps_to_same_interval_for_accel_and_decel) {
+    for (uint16_t stair = 1; stair < this->RAMP_STAIRS; ++stair) {
+        const float speed = TestFixture::speed(stair);
+
+        ASSERT_EQ(TestFixture::Ramp::interval(TestFixture::Ramp::maxAccelStairs(speed)), TestFixture::Ramp::interval(stair));
+        ASSERT_EQ(TestFixture::Ramp::interval(TestFixture::Ramp::maxAccelStairs(-speed)), TestFixture::Ramp::interval(stair));
+    }
+}
+
+/// Stepper driven by an S-curve ramp with the shared desktop test limits.
+using SCurveStepper = Stepper<
+    Interrupt,
+    Driver,
+    SCurveRamp<
+        TEST_RAMP_STAIRS,
+        F_CPU,
+        static_cast<uint32_t>(FAST_SPEED),
+        static_cast<uint32_t>(FAST_ACCELERATION),
+        static_cast<uint32_t>(FAST_ACCELERATION * 4)>>;
+
+struct SCurveStepperTest : public StepperBehaviorTestBase
+{
+protected:
+  void TearDown() override
+  {
+    SCurveStepper::reset();
+    StepperBehaviorTestBase::TearDown();
+  }
+};
+
+// The S-curve ramp is a drop-in replacement for `AccelerationRamp`.
+TEST_F(SCurveStepperTest, MovesToTargetAndStops)
+{
+  EXPECT_CALL(*Interrupt::mock, stop()).Times(::testing::AnyNumber());
+  EXPECT_CALL(*Interrupt::mock, setInterval(::testing::_)).Times(::testing::AnyNumber());
+  EXPECT_CALL(*Driver::mock, step()).Times(::testing::AnyNumber());
+  EXPECT_CALL(*Driver::mock, dir(::testing::_)).Times(::testing::AnyNumber());
+
+  SCurveStepper::moveBy(FAST_SPEED, 100000);
+  Interrupt::loopUntilStopped(UINT32_MAX);
+  EXPECT_EQ(100000, Driver::position);
+  EXPECT_EQ(100000, SCurveStepper::getPosition());
+
+  SCurveStepper::moveTo(FAST_SPEED / 3, -1234);
+  Interrupt::loopUntilStopped(UINT32_MAX);
+  EXPECT_EQ(-1234, Driver::position);
+  EXPECT_EQ(0U, SCurveStepper::distanceToGo());
+  EXPECT_FALSE(SCurveStepper::isRunning());
+}
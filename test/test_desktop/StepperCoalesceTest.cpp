@@ -0,0 +1,384 @@
+#include <cstdlib>
+#include <vector>
+
+#include "IntervalInterrupt.h"
+#include "Stepper.h"
+#include "TimerPrescaler.h"
+
+#include "gtest/gtest.h"
+
+namespace
+{
+/// Simulated timer. Time only advances from interrupt to interrupt and while a burst polls `elapsed()`.
+template <uint8_t ID>
+struct FakeTimer
+{
+  constexpr static unsigned long int FREQ = F_CPU;
+
+  static timer_callback callback;
+  static uint32_t interval;
+  static uint32_t fired_at;
+  static uint32_t now;
+  static uint32_t interrupts;
+
+  static void init()
+  {
+  }
+
+  static void setCallback(const timer_callback fn)
+  {
+    callback = fn;
+  }
+
+  static void setInterval(const uint32_t value)
+  {
+    interval = value;
+  }
+
+  static void stop()
+  {
+    callback = nullptr;
+  }
+
+  /// Every poll takes one tick.
+  static uint32_t elapsed()
+  {
+    return now++ - fired_at;
+  }
+
+  static void reset()
+  {
+    callback = nullptr;
+    fired_at = 0;
+    now = 0;
+    interrupts = 0;
+  }
+
+  /**
+   * @brief Fire the interrupt at its deadlines until the stepper stops or `until` is reached.
+   */
+  static void run(const uint32_t until = UINT32_MAX)
+  {
+    while (callback != nullptr && fired_at + interval <= until)
+    {
+      fired_at += interval;
+      now = fired_at;
+      interrupts++;
+      callback();
+    }
+  }
+};
+
+template <uint8_t ID>
+timer_callback FakeTimer<ID>::callback = nullptr;
+template <uint8_t ID>
+uint32_t FakeTimer<ID>::interval = 0;
+template <uint8_t ID>
+uint32_t FakeTimer<ID>::fired_at = 0;
+template <uint8_t ID>
+uint32_t FakeTimer<ID>::now = 0;
+template <uint8_t ID>
+uint32_t FakeTimer<ID>::interrupts = 0;
+
+/**
+ * @brief Simulated AVR timer on a selected prescaler, see `internal::TimerPrescaler`.
+ *
+ * Intervals are rounded down to whole prescaled ticks with the residue carried, and a repeated
+ * interval is split again, as the AVR backend does. `elapsed()` counts whole prescaled ticks since
+ * the compare match, minus how early the match came.
+ */
+template <uint8_t ID>
+struct PrescaledTimer
+{
+  constexpr static unsigned long int FREQ = F_CPU;
+
+  static timer_callback callback;
+  static uint32_t value;
+  static uint32_t cycles;
+  static uint32_t fired_at;
+  static uint32_t now;
+  static uint8_t shift;
+  static uint8_t max_shift;
+  static uint16_t residue;
+  static uint16_t lead;
+  static bool carries;
+  static bool programmed;
+
+  static void init()
+  {
+  }
+
+  static void setCallback(const timer_callback fn)
+  {
+    callback = fn;
+  }
+
+  static void setInterval(const uint32_t interval)
+  {
+    value = interval;
+    programmed = true;
+    split();
+  }
+
+  static void stop()
+  {
+    callback = nullptr;
+    residue = 0;
+    lead = 0;
+  }
+
+  /// Every poll takes one cycle.
+  static uint32_t elapsed()
+  {
+    return (((now++ - fired_at) >> shift) << shift) - lead;
+  }
+
+  static void reset()
+  {
+    callback = nullptr;
+    fired_at = 0;
+    now = 0;
+    max_shift = 0;
+    residue = 0;
+    lead = 0;
+  }
+
+  static void run()
+  {
+    while (callback != nullptr)
+    {
+      fired_at += cycles;
+      now = fired_at;
+      lead = residue;
+      programmed = false;
+      callback();
+      if (callback != nullptr && !programmed && carries)
+      {
+        split();
+      }
+    }
+  }
+
+private:
+  static void split()
+  {
+    const uint16_t carried = residue;
+    const internal::PrescaledInterval next = internal::TimerPrescaler::split(value, residue);
+    carries = residue != carried;
+    shift = next.shift;
+    max_shift = (shift > max_shift) ? shift : max_shift;
+    cycles = ((static_cast<uint32_t>(next.ovf) << 16) + next.ocr + 1) << next.shift;
+  }
+};
+
+template <uint8_t ID>
+timer_callback PrescaledTimer<ID>::callback = nullptr;
+template <uint8_t ID>
+uint32_t PrescaledTimer<ID>::value = 0;
+template <uint8_t ID>
+uint32_t PrescaledTimer<ID>::cycles = 0;
+template <uint8_t ID>
+uint32_t PrescaledTimer<ID>::fired_at = 0;
+template <uint8_t ID>
+uint32_t PrescaledTimer<ID>::now = 0;
+template <uint8_t ID>
+uint8_t PrescaledTimer<ID>::shift = 0;
+template <uint8_t ID>
+uint8_t PrescaledTimer<ID>::max_shift = 0;
+template <uint8_t ID>
+uint16_t PrescaledTimer<ID>::residue = 0;
+template <uint8_t ID>
+uint16_t PrescaledTimer<ID>::lead = 0;
+template <uint8_t ID>
+bool PrescaledTimer<ID>::carries = false;
+template <uint8_t ID>
+bool PrescaledTimer<ID>::programmed = false;
+
+/// Driver that records the time of every step and keeps its own position.
+template <uint8_t ID>
+struct TimedDriver
+{
+  constexpr static uint32_t SPR = 400 * 256;
+
+  static std::vector<uint32_t> times;
+  static bool forward;
+  static int32_t position;
+
+  static void init()
+  {
+  }
+
+  static void step()
+  {
+    times.push_back(ID == 2 ? PrescaledTimer<ID>::now : FakeTimer<ID>::now);
+    position += forward ? 1 : -1;
+  }
+
+  static void dir(const bool value)
+  {
+    forward = value;
+  }
+
+  static void setInverted(bool)
+  {
+  }
+};
+
+template <uint8_t ID>
+std::vector<uint32_t> TimedDriver<ID>::times;
+template <uint8_t ID>
+bool TimedDriver<ID>::forward = true;
+template <uint8_t ID>
+int32_t TimedDriver<ID>::position = 0;
+
+/// Four steps per interrupt from 10000 steps/s on.
+using BurstRamp = AccelerationRamp<256, F_CPU, 40352, 40352, 10000, 4>;
+using SingleRamp = AccelerationRamp<256, F_CPU, 40352, 40352>;
+
+using Single = Stepper<FakeTimer<0>, TimedDriver<0>, SingleRamp>;
+using Burst = Stepper<FakeTimer<1>, TimedDriver<1>, BurstRamp>;
+using PrescaledBurst = Stepper<PrescaledTimer<2>, TimedDriver<2>, BurstRamp>;
+} // namespace
+
+struct StepperCoalesceTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    FakeTimer<0>::reset();
+    FakeTimer<1>::reset();
+    PrescaledTimer<2>::reset();
+    TimedDriver<0>::times.clear();
+    TimedDriver<1>::times.clear();
+    TimedDriver<2>::times.clear();
+    TimedDriver<0>::position = 0;
+    TimedDriver<1>::position = 0;
+    TimedDriver<2>::position = 0;
+  }
+
+  void TearDown() override
+  {
+    Single::terminate(false);
+    Burst::terminate(false);
+    PrescaledBurst::terminate(false);
+    Single::reset();
+    Burst::reset();
+    PrescaledBurst::reset();
+  }
+
+  /// Assert that `burst` stepped at the same times as the single stepper, up to `tolerance` ticks.
+  static void expectSameTiming(const std::vector<uint32_t> &burst = TimedDriver<1>::times, const uint32_t tolerance = 2)
+  {
+    const std::vector<uint32_t> &single = TimedDriver<0>::times;
+
+    ASSERT_EQ(single.size(), burst.size());
+    uint32_t worst = 0;
+    for (size_t i = 0; i < single.size(); i++)
+    {
+      const auto diff = static_cast<uint32_t>(std::abs(static_cast<int64_t>(burst[i]) - static_cast<int64_t>(single[i])));
+      worst = (diff > worst) ? diff : worst;
+    }
+    EXPECT_LE(worst, tolerance);
+  }
+};
+
+TEST_F(StepperCoalesceTest, RampExposesThreshold)
+{
+  EXPECT_EQ(F_CPU / 10000, BurstRamp::COALESCE_INTERVAL);
+  EXPECT_EQ(4, BurstRamp::COALESCE_STEPS);
+  EXPECT_EQ(0U, SingleRamp::COALESCE_INTERVAL);
+}
+
+// Bursts emit the same pulse train as one interrupt per step, with a quarter of the interrupts at top speed.
+TEST_F(StepperCoalesceTest, BurstsKeepStepTimingAboveThreshold)
+{
+  Single::moveTo(40000.0f, 200000);
+  Burst::moveTo(40000.0f, 200000);
+  FakeTimer<0>::run();
+  FakeTimer<1>::run();
+
+  expectSameTiming();
+  EXPECT_EQ(200000, Burst::getPosition());
+  EXPECT_EQ(200000, TimedDriver<1>::position);
+  EXPECT_EQ(200000U, FakeTimer<0>::interrupts);
+  EXPECT_LT(FakeTimer<1>::interrupts, 200000U * 3 / 10);
+}
+
+// Dithered run intervals carry the fraction of a whole burst, so the pulse train still matches.
+TEST_F(StepperCoalesceTest, BurstsKeepExactRate)
+{
+  Single::move(Single::MovementSpec::exact(33333.3f, 150000));
+  Burst::move(Burst::MovementSpec::exact(33333.3f, 150000));
+  FakeTimer<0>::run();
+  FakeTimer<1>::run();
+
+  expectSameTiming();
+  EXPECT_EQ(150000, Burst::getPosition());
+}
+
+// Below the threshold every step keeps its own interrupt.
+TEST_F(StepperCoalesceTest, NoBurstsBelowThreshold)
+{
+  Burst::moveTo(8000.0f, 30000);
+  FakeTimer<1>::run();
+
+  EXPECT_EQ(30000, Burst::getPosition());
+  EXPECT_EQ(30000U, FakeTimer<1>::interrupts);
+}
+
+// Re-planning, reversing and stopping between bursts keeps the position exact after every interrupt
+// and never squeezes two steps closer together than the fastest stair allows.
+TEST_F(StepperCoalesceTest, PositionStaysExactAcrossReplans)
+{
+  bool exact = true;
+  const auto run = [&exact](const uint32_t until)
+  {
+    while (FakeTimer<1>::callback != nullptr && FakeTimer<1>::fired_at + FakeTimer<1>::interval <= until)
+    {
+      FakeTimer<1>::run(FakeTimer<1>::fired_at + FakeTimer<1>::interval);
+      exact = exact && (Burst::getPosition() == TimedDriver<1>::position);
+    }
+  };
+
+  Burst::moveTo(40000.0f, 100000);
+  run(F_CPU);
+  Burst::moveTo(25000.0f, -20000);
+  run(F_CPU * 4);
+  Burst::move(30000.0f);
+  run(F_CPU * 6);
+  Burst::stop();
+  run(UINT32_MAX);
+
+  EXPECT_TRUE(exact);
+  EXPECT_FALSE(Burst::isRunning());
+  EXPECT_EQ(TimedDriver<1>::position, Burst::getPosition());
+
+  const std::vector<uint32_t> &times = TimedDriver<1>::times;
+  uint32_t shortest = UINT32_MAX;
+  for (size_t i = 1; i < times.size(); i++)
+  {
+    shortest = (times[i] - times[i - 1] < shortest) ? times[i] - times[i - 1] : shortest;
+  }
+  EXPECT_GE(shortest + 1, BurstRamp::interval(BurstRamp::STAIRS_COUNT - 1));
+}
+
+// The first and last stairs of a ramp from standstill run on prescaler 8, whose rounding leaves a
+// residue for the first burst, and a slow dithered run stays on it. The steps still land within one
+// prescaled tick of one interrupt per step.
+TEST_F(StepperCoalesceTest, BurstsAfterPrescaledIntervalsKeepStepTiming)
+{
+  Single::moveTo(40000.0f, 100000);
+  PrescaledBurst::moveTo(40000.0f, 100000);
+  FakeTimer<0>::run();
+  PrescaledTimer<2>::run();
+
+  Single::move(Single::MovementSpec::exact(150.3f, 2000));
+  PrescaledBurst::move(PrescaledBurst::MovementSpec::exact(150.3f, 2000));
+  FakeTimer<0>::run();
+  PrescaledTimer<2>::run();
+
+  EXPECT_EQ(3, PrescaledTimer<2>::max_shift);
+  EXPECT_EQ(102000, PrescaledBurst::getPosition());
+  EXPECT_EQ(102000, TimedDriver<2>::position);
+  expectSameTiming(TimedDriver<2>::times, (1U << 3) + 2);
+}
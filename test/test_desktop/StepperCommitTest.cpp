@@ -0,0 +1,176 @@
+#include "StepperTestSupport.h"
+
+using ::testing::_;
+using ::testing::AnyNumber;
+using ::testing::InSequence;
+
+namespace
+{
+int completed_moves = 0;
+
+void onMoveComplete()
+{
+  completed_moves++;
+}
+} // namespace
+
+struct StepperCommitTest : public StepperBehaviorTestBase
+{
+protected:
+  void SetUp() override
+  {
+    StepperBehaviorTestBase::SetUp();
+    completed_moves = 0;
+    ::internal::InterruptLock::enabled = true;
+  }
+
+  /**
+   * @brief Allow any timer and driver traffic for tests that only assert the resulting state.
+   */
+  static void allowStepping()
+  {
+    EXPECT_CALL(*Interrupt::mock, stop()).Times(AnyNumber());
+    EXPECT_CALL(*Interrupt::mock, setInterval(_)).Times(AnyNumber());
+    EXPECT_CALL(*Driver::mock, step()).Times(AnyNumber());
+    EXPECT_CALL(*Driver::mock, dir(_)).Times(AnyNumber());
+  }
+};
+
+TEST_F(StepperCommitTest, PlanningDoesNotTouchTimerOrDriver)
+{
+  // The strict mocks fail on any stop(), setInterval() or dir() call made while planning.
+  const TestStepper::Plan plan = TestStepper::planMove(TestStepper::MovementSpec::distance(FAST_SPEED, 1000));
+
+  EXPECT_FALSE(TestStepper::isRunning());
+  EXPECT_EQ(0U, TestStepper::distanceToGo());
+
+  {
+    InSequence seq;
+    EXPECT_CALL(*Interrupt::mock, stop());
+    EXPECT_CALL(*Driver::mock, dir(true));
+    EXPECT_CALL(*Interrupt::mock, setInterval(Ramp::REAL_TYPE::interval(1)));
+  }
+
+  EXPECT_TRUE(TestStepper::commit(plan));
+  EXPECT_TRUE(TestStepper::isRunning());
+  EXPECT_EQ(1000U, TestStepper::distanceToGo());
+}
+
+TEST_F(StepperCommitTest, StalePlanIsRejected)
+{
+  allowStepping();
+
+  TestStepper::moveBy(FAST_SPEED, 100000);
+  runInterruptSteps(Ramp::STEPS_PER_STAIR, false);
+
+  const TestStepper::Plan plan = TestStepper::planMove(TestStepper::MovementSpec::distance(FAST_SPEED, 5000));
+
+  // The handlers climb another stair before the plan is committed.
+  runInterruptSteps(Ramp::STEPS_PER_STAIR, false);
+  const int32_t position = TestStepper::getPosition();
+  const uint32_t distance = TestStepper::distanceToGo();
+
+  EXPECT_FALSE(TestStepper::commit(plan));
+  expectStepperState(position, distance, true);
+
+  ASSERT_TRUE(TestStepper::commit(TestStepper::planMove(TestStepper::MovementSpec::distance(FAST_SPEED, 5000))));
+  runInterruptSteps(UINT32_MAX);
+  expectIdleState(position + 5000);
+}
+
+TEST_F(StepperCommitTest, PlanStaysValidWithinTheSameStair)
+{
+  allowStepping();
+
+  TestStepper::moveBy(FAST_SPEED, 100000);
+  runInterruptSteps(Ramp::STEPS_PER_STAIR + 1U, false);
+
+  const TestStepper::Plan plan = TestStepper::planMove(TestStepper::MovementSpec::distance(-FAST_SPEED, 3000));
+
+  runInterruptSteps(Ramp::STEPS_PER_STAIR / 2U, false);
+  const int32_t position = TestStepper::getPosition();
+
+  ASSERT_TRUE(TestStepper::commit(plan));
+  runInterruptSteps(UINT32_MAX);
+  expectIdleState(position - 3000);
+}
+
+TEST_F(StepperCommitTest, CommittingAnEmptyPlanTerminatesWithCallback)
+{
+  EXPECT_CALL(*Interrupt::mock, stop()).Times(2);
+
+  const TestStepper::Plan plan = TestStepper::planMove(
+      TestStepper::MovementSpec::distance(SLOW_SPEED, 0),
+      StepperCallback::create<onMoveComplete>());
+
+  EXPECT_TRUE(TestStepper::commit(plan));
+  EXPECT_EQ(1, completed_moves);
+  expectIdleState(0);
+}
+
+TEST_F(StepperCommitTest, AbsolutePlanEndsOnTargetDespiteStepsBeforeCommit)
+{
+  allowStepping();
+
+  TestStepper::moveBy(FAST_SPEED, 100000);
+  runInterruptSteps(Ramp::STEPS_PER_STAIR + 1U, false);
+
+  const TestStepper::Plan plan = TestStepper::planMoveTo(20000, TestStepper::MovementSpec::distance(FAST_SPEED, 0));
+
+  // The handlers keep stepping on the same stair while the plan waits for its commit.
+  runInterruptSteps(Ramp::STEPS_PER_STAIR / 2U, false);
+
+  ASSERT_TRUE(TestStepper::commit(plan));
+  runInterruptSteps(UINT32_MAX);
+  expectIdleState(20000);
+}
+
+TEST_F(StepperCommitTest, AbsolutePlanReversesOntoTargetDespiteStepsBeforeCommit)
+{
+  allowStepping();
+
+  TestStepper::moveBy(FAST_SPEED, 100000);
+  runInterruptSteps(Ramp::STEPS_PER_STAIR + 1U, false);
+
+  const TestStepper::Plan plan = TestStepper::planMoveTo(-3000, TestStepper::MovementSpec::distance(FAST_SPEED, 0));
+
+  runInterruptSteps(Ramp::STEPS_PER_STAIR / 2U, false);
+
+  ASSERT_TRUE(TestStepper::commit(plan));
+  runInterruptSteps(UINT32_MAX);
+  expectIdleState(-3000);
+}
+
+TEST_F(StepperCommitTest, AbsolutePlanEndsOnTargetFromSlowRun)
+{
+  allowStepping();
+
+  TestStepper::moveBy(SLOW_SPEED, 100000);
+  runInterruptSteps(10, false);
+
+  const TestStepper::Plan plan = TestStepper::planMoveTo(500, TestStepper::MovementSpec::distance(SLOW_SPEED, 0));
+
+  runInterruptSteps(7, false);
+
+  ASSERT_TRUE(TestStepper::commit(plan));
+  runInterruptSteps(UINT32_MAX);
+  expectIdleState(500);
+}
+
+TEST_F(StepperCommitTest, CommitsKeepTheCallersInterruptState)
+{
+  allowStepping();
+
+  // A completion callback runs with interrupts disabled and may start the next move.
+  ::internal::InterruptLock::enabled = false;
+  TestStepper::moveBy(FAST_SPEED, 1000);
+  TestStepper::moveTo(FAST_SPEED, -200);
+  EXPECT_TRUE(TestStepper::enqueue(TestStepper::MovementSpec::distance(SLOW_SPEED, 50)));
+  EXPECT_EQ(1U, TestStepper::queuedSegments());
+  TestStepper::setPosition(0);
+  EXPECT_FALSE(::internal::InterruptLock::enabled);
+
+  ::internal::InterruptLock::enabled = true;
+  TestStepper::moveBy(FAST_SPEED, 1000);
+  EXPECT_TRUE(::internal::InterruptLock::enabled);
+}
@@ -0,0 +1,127 @@
+#include <cmath>
+
+#include "StepperTestSupport.h"
+
+using ::testing::_;
+using ::testing::AnyNumber;
+
+namespace
+{
+/// Interval the simulated timer currently waits between two callbacks.
+uint32_t current_interval = 0;
+/// Simulated timer ticks elapsed since the move was started.
+uint64_t elapsed_ticks = 0;
+
+/// Speed whose interval has a large fraction (1333.28 ticks), so truncation is clearly visible.
+constexpr float FRACTIONAL_SPEED = 12000.5f;
+} // namespace
+
+struct StepperDitherTest : public StepperBehaviorTestBase
+{
+protected:
+  void SetUp() override
+  {
+    StepperBehaviorTestBase::SetUp();
+
+    current_interval = 0;
+    elapsed_ticks = 0;
+
+    ON_CALL(*Interrupt::mock, setInterval(_)).WillByDefault([](const uint32_t value) { current_interval = value; });
+
+    EXPECT_CALL(*Interrupt::mock, stop()).Times(AnyNumber());
+    EXPECT_CALL(*Interrupt::mock, setInterval(_)).Times(AnyNumber());
+    EXPECT_CALL(*Driver::mock, step()).Times(AnyNumber());
+    EXPECT_CALL(*Driver::mock, dir(_)).Times(AnyNumber());
+  }
+
+  /**
+   * @brief Run `steps` timer callbacks and account for the time the timer waited before each.
+   */
+  static void runTimed(const uint32_t steps)
+  {
+    for (uint32_t i = 0; i < steps && Interrupt::mock->callback != nullptr; i++)
+    {
+      elapsed_ticks += current_interval;
+      Interrupt::mock->callback();
+    }
+  }
+
+  /**
+   * @brief Relative deviation of the average step rate over `steps` steady-state run steps.
+   */
+  static double measureRateError(const float speed, const uint32_t steps)
+  {
+    const uint64_t start = elapsed_ticks;
+    runTimed(steps);
+
+    const double expected = static_cast<double>(F_CPU) / static_cast<double>(speed) * steps;
+    return (static_cast<double>(elapsed_ticks - start) - expected) / expected;
+  }
+};
+
+// A plain move truncates the interval and runs measurably fast.
+TEST_F(StepperDitherTest, PlainRunIsFastByTruncatedFraction)
+{
+  TestStepper::move(FRACTIONAL_SPEED);
+  runTimed(10000);
+
+  EXPECT_LT(measureRateError(FRACTIONAL_SPEED, 200000), -100e-6);
+}
+
+// The dithered multistep run matches the requested rate to better than 1 ppm.
+TEST_F(StepperDitherTest, ExactFastRunMatchesRequestedRate)
+{
+  TestStepper::moveExact(FRACTIONAL_SPEED);
+  runTimed(10000);
+
+  EXPECT_LT(std::fabs(measureRateError(FRACTIONAL_SPEED, 200000)), 1e-6);
+}
+
+// The dithered single-step run at a tracking-like speed matches the requested rate as well.
+TEST_F(StepperDitherTest, ExactSlowRunMatchesRequestedRate)
+{
+  TestStepper::moveExact(SLOW_SPEED);
+  runTimed(1);
+
+  EXPECT_LT(std::fabs(measureRateError(SLOW_SPEED, 70000)), 1e-6);
+}
+
+// The integer speed path carries the fraction too.
+TEST_F(StepperDitherTest, ExactFixedSpeedRunMatchesRequestedRate)
+{
+  TestStepper::moveExact(FixedSpeed::milli(12000500));
+  runTimed(10000);
+
+  EXPECT_LT(std::fabs(measureRateError(FRACTIONAL_SPEED, 200000)), 1e-6);
+}
+
+// Intervals only ever alternate between the truncated interval and one tick more.
+TEST_F(StepperDitherTest, IntervalsAlternateByOneTick)
+{
+  const uint32_t interval = Ramp::REAL_TYPE::getIntervalForSpeed(FRACTIONAL_SPEED);
+
+  TestStepper::moveExact(FRACTIONAL_SPEED);
+  runTimed(10000);
+
+  uint32_t stretched = 0;
+  for (uint32_t i = 0; i < 65536; i++)
+  {
+    runTimed(1);
+    ASSERT_TRUE(current_interval == interval || current_interval == interval + 1) << current_interval;
+    stretched += (current_interval == interval + 1) ? 1 : 0;
+  }
+
+  EXPECT_EQ(Ramp::REAL_TYPE::getIntervalFractionForSpeed(FRACTIONAL_SPEED), stretched);
+}
+
+// The dithered run still ends on the exact target and restores the plain interval afterwards.
+TEST_F(StepperDitherTest, ExactDistanceReachesTarget)
+{
+  TestStepper::move(TestStepper::MovementSpec::exact(-FRACTIONAL_SPEED, 50000));
+  runInterruptSteps(UINT32_MAX);
+  expectIdleState(-50000);
+
+  TestStepper::move(TestStepper::MovementSpec::exact(SLOW_SPEED, 300));
+  runInterruptSteps(UINT32_MAX);
+  expectIdleState(-49700);
+}
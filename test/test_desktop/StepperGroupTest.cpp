@@ -0,0 +1,148 @@
+#include <vector>
+
+#include "StepperGroup.h"
+#include "StepperTestSupport.h"
+
+using ::testing::_;
+using ::testing::AnyNumber;
+using ::testing::NiceMock;
+
+namespace
+{
+using AxisY = MockedDriver<2>;
+using AxisZ = MockedDriver<3>;
+
+using Group = StepperGroup<Interrupt, Ramp::REAL_TYPE, Driver, AxisY, AxisZ>;
+
+/// Intervals the simulated timer was programmed with, in call order.
+std::vector<uint32_t> intervals;
+/// Timer callbacks executed so far.
+uint32_t tick = 0;
+/// Tick of the most recent step of each axis.
+uint32_t last_step[Group::AXES] = {};
+} // namespace
+
+struct StepperGroupTest : public StepperBehaviorTestBase
+{
+protected:
+  void SetUp() override
+  {
+    StepperBehaviorTestBase::SetUp();
+
+    AxisY::mock = new NiceMock<DriverMock>();
+    AxisZ::mock = new NiceMock<DriverMock>();
+    AxisY::position = 0;
+    AxisZ::position = 0;
+
+    intervals.clear();
+    tick = 0;
+    for (uint32_t &value : last_step)
+    {
+      value = 0;
+    }
+
+    ON_CALL(*Interrupt::mock, setInterval(_)).WillByDefault([](const uint32_t value) { intervals.push_back(value); });
+    ON_CALL(*Driver::mock, step()).WillByDefault([]() { last_step[0] = tick; });
+    ON_CALL(*AxisY::mock, step()).WillByDefault([]() { last_step[1] = tick; });
+    ON_CALL(*AxisZ::mock, step()).WillByDefault([]() { last_step[2] = tick; });
+
+    EXPECT_CALL(*Interrupt::mock, stop()).Times(AnyNumber());
+    EXPECT_CALL(*Interrupt::mock, setInterval(_)).Times(AnyNumber());
+    EXPECT_CALL(*Driver::mock, step()).Times(AnyNumber());
+    EXPECT_CALL(*Driver::mock, dir(_)).Times(AnyNumber());
+  }
+
+  void TearDown() override
+  {
+    Group::reset();
+
+    delete AxisY::mock;
+    delete AxisZ::mock;
+
+    StepperBehaviorTestBase::TearDown();
+  }
+
+  static void runTicks()
+  {
+    while (Interrupt::mock->callback != nullptr)
+    {
+      tick++;
+      Interrupt::mock->callback();
+    }
+  }
+
+  static void expectAxes(const int32_t x, const int32_t y, const int32_t z)
+  {
+    EXPECT_EQ(x, Driver::position);
+    EXPECT_EQ(y, AxisY::position);
+    EXPECT_EQ(z, AxisZ::position);
+
+    EXPECT_EQ(x, Group::getPosition(0));
+    EXPECT_EQ(y, Group::getPosition(1));
+    EXPECT_EQ(z, Group::getPosition(2));
+  }
+};
+
+// Every axis reaches its exact target and makes its last step on the same tick.
+TEST_F(StepperGroupTest, AxesReachTargetsTogether)
+{
+  EXPECT_TRUE(Group::moveTo(20000.0f, {100000, -37001, 3}));
+  EXPECT_FALSE(Group::moveTo(20000.0f, {0, 0, 0}));
+  runTicks();
+
+  expectAxes(100000, -37001, 3);
+  EXPECT_EQ(100000U, tick);
+  EXPECT_EQ(tick, last_step[0]);
+  EXPECT_EQ(tick, last_step[1]);
+  EXPECT_EQ(tick, last_step[2]);
+
+  // the dominant axis may change from line to line
+  tick = 0;
+  EXPECT_TRUE(Group::moveBy(FixedSpeed::sps(-8000), {-1, 4000, -2999}));
+  runTicks();
+
+  expectAxes(99999, -33001, -2996);
+  EXPECT_EQ(4000U, tick);
+  EXPECT_EQ(tick, last_step[0]);
+  EXPECT_EQ(tick, last_step[1]);
+  EXPECT_EQ(tick, last_step[2]);
+}
+
+// The dominant axis is timed exactly like a single-axis stepper.
+TEST_F(StepperGroupTest, DominantAxisMatchesSingleStepper)
+{
+  Group::moveBy(20000.0f, {-50000, 20000, 7});
+  runTicks();
+  const std::vector<uint32_t> group_intervals = intervals;
+
+  intervals.clear();
+  TestStepper::moveBy(20000.0f, 50000);
+  runTicks();
+
+  EXPECT_EQ(intervals, group_intervals);
+}
+
+// A stop decelerates along the line, so the axes keep their ratio.
+TEST_F(StepperGroupTest, StopStaysOnLine)
+{
+  Group::setPosition({10, 20, 30});
+  Group::moveBy(20000.0f, {80000, 40000, -20000});
+
+  for (uint32_t i = 0; i < 30000; i++)
+  {
+    Interrupt::mock->callback();
+  }
+  Group::stop();
+  runTicks();
+
+  EXPECT_FALSE(Group::isRunning());
+  const int32_t x = Driver::position;
+  EXPECT_GT(x, 30000);
+  EXPECT_LT(x, 80000);
+  EXPECT_EQ(x / 2, AxisY::position);
+  EXPECT_EQ(-(x / 4), AxisZ::position);
+
+  EXPECT_EQ(x + 10, Group::getPosition(0));
+  EXPECT_EQ((x / 2) + 20, Group::getPosition(1));
+  EXPECT_EQ(30 - (x / 4), Group::getPosition(2));
+}
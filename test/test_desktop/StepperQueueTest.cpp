@@ -0,0 +1,198 @@
+#include <cstdlib>
+#include <vector>
+
+#include "StepperTestSupport.h"
+
+using ::testing::_;
+using ::testing::AnyNumber;
+
+namespace
+{
+std::vector<int> completed_segments;
+
+template <int ID>
+void onSegmentComplete()
+{
+  completed_segments.push_back(ID);
+}
+
+/// Distance that comfortably fits a full acceleration and deceleration ramp.
+constexpr int32_t LONG_SEGMENT_STEPS = static_cast<int32_t>(Ramp::REAL_TYPE::STEPS_TOTAL) * 3;
+} // namespace
+
+/**
+ * @brief Fixture that simulates the timer and accumulates the elapsed timer ticks.
+ *
+ * Every simulated interrupt is charged with the interval that was programmed before it fired, so
+ * `elapsed` is the time the motor needs for the executed steps.
+ */
+struct StepperQueueTest : public StepperBehaviorTestBase
+{
+protected:
+  uint32_t interval = 0;
+  uint64_t elapsed = 0;
+
+  void SetUp() override
+  {
+    StepperBehaviorTestBase::SetUp();
+    completed_segments.clear();
+
+    EXPECT_CALL(*Interrupt::mock, stop()).Times(AnyNumber());
+    EXPECT_CALL(*Interrupt::mock, setInterval(_))
+        .WillRepeatedly([this](const uint32_t value)
+                        { interval = value; });
+    EXPECT_CALL(*Driver::mock, step()).Times(AnyNumber());
+    EXPECT_CALL(*Driver::mock, dir(_)).Times(AnyNumber());
+  }
+
+  void runTimed(const uint32_t limit = UINT32_MAX, const bool expectStopped = true)
+  {
+    uint32_t loop = 0;
+    while (loop++ < limit && Interrupt::mock->callback != nullptr)
+    {
+      elapsed += interval;
+      Interrupt::mock->callback();
+    }
+    if (expectStopped)
+    {
+      ASSERT_EQ(Interrupt::mock->callback, nullptr);
+    }
+  }
+};
+
+TEST_F(StepperQueueTest, ChainedMovesFinishCloseToOneCombinedMove)
+{
+  constexpr int segments = 4;
+
+  TestStepper::moveBy(FAST_SPEED, LONG_SEGMENT_STEPS * segments);
+  runTimed();
+  expectIdleState(LONG_SEGMENT_STEPS * segments);
+  const uint64_t combined = elapsed;
+
+  TestStepper::reset();
+  Driver::position = 0;
+  elapsed = 0;
+
+  for (int i = 0; i < segments; i++)
+  {
+    ASSERT_TRUE(TestStepper::enqueue(TestStepper::MovementSpec::distance(FAST_SPEED, LONG_SEGMENT_STEPS)));
+  }
+  EXPECT_EQ(static_cast<uint32_t>(LONG_SEGMENT_STEPS * segments), TestStepper::distanceToGo());
+
+  TestStepper::startQueue();
+  EXPECT_EQ(static_cast<uint32_t>(LONG_SEGMENT_STEPS * segments), TestStepper::distanceToGo());
+
+  runTimed();
+  expectIdleState(LONG_SEGMENT_STEPS * segments);
+  const uint64_t chained = elapsed;
+
+  EXPECT_NEAR(static_cast<double>(combined), static_cast<double>(chained), static_cast<double>(combined) * 0.01);
+}
+
+TEST_F(StepperQueueTest, ChainedMovesAreFasterThanStopAndGo)
+{
+  constexpr int segments = 4;
+
+  for (int i = 0; i < segments; i++)
+  {
+    TestStepper::moveBy(FAST_SPEED, LONG_SEGMENT_STEPS);
+    runTimed();
+  }
+  expectIdleState(LONG_SEGMENT_STEPS * segments);
+  const uint64_t stop_and_go = elapsed;
+
+  TestStepper::reset();
+  Driver::position = 0;
+  elapsed = 0;
+
+  for (int i = 0; i < segments; i++)
+  {
+    ASSERT_TRUE(TestStepper::enqueue(TestStepper::MovementSpec::distance(FAST_SPEED, LONG_SEGMENT_STEPS)));
+  }
+  TestStepper::startQueue();
+  runTimed();
+  expectIdleState(LONG_SEGMENT_STEPS * segments);
+
+  EXPECT_LT(elapsed, stop_and_go);
+}
+
+TEST_F(StepperQueueTest, SegmentCallbacksFireInOrderAtEachBoundary)
+{
+  ASSERT_TRUE(TestStepper::enqueue(
+      TestStepper::MovementSpec::distance(FAST_SPEED, LONG_SEGMENT_STEPS),
+      StepperCallback::create<onSegmentComplete<1>>()));
+  ASSERT_TRUE(TestStepper::enqueue(
+      TestStepper::MovementSpec::distance(FAST_SPEED / 2, LONG_SEGMENT_STEPS),
+      StepperCallback::create<onSegmentComplete<2>>()));
+  ASSERT_TRUE(TestStepper::enqueue(
+      TestStepper::MovementSpec::distance(FAST_SPEED, 1000),
+      StepperCallback::create<onSegmentComplete<3>>()));
+
+  TestStepper::startQueue();
+
+  runTimed(static_cast<uint32_t>(LONG_SEGMENT_STEPS) - 1U, false);
+  EXPECT_TRUE(completed_segments.empty());
+  EXPECT_EQ(2U, TestStepper::queuedSegments());
+
+  runTimed(1, false);
+  ASSERT_EQ(std::vector<int>({1}), completed_segments);
+  expectPosition(LONG_SEGMENT_STEPS);
+  EXPECT_TRUE(TestStepper::isRunning());
+
+  runTimed();
+  EXPECT_EQ(std::vector<int>({1, 2, 3}), completed_segments);
+  expectIdleState(LONG_SEGMENT_STEPS * 2 + 1000);
+}
+
+TEST_F(StepperQueueTest, DirectionChangeStopsAtTheJunction)
+{
+  ASSERT_TRUE(TestStepper::enqueue(TestStepper::MovementSpec::distance(FAST_SPEED, LONG_SEGMENT_STEPS)));
+  ASSERT_TRUE(TestStepper::enqueue(TestStepper::MovementSpec::distance(-FAST_SPEED, LONG_SEGMENT_STEPS / 2)));
+
+  TestStepper::startQueue();
+
+  // The first segment has to come to a complete stop before reversing.
+  runTimed(static_cast<uint32_t>(LONG_SEGMENT_STEPS) - 1U, false);
+  runTimed(1, false);
+  expectPosition(LONG_SEGMENT_STEPS);
+
+  runTimed();
+  expectIdleState(LONG_SEGMENT_STEPS / 2);
+}
+
+TEST_F(StepperQueueTest, SegmentsQueuedDuringMoveStartAfterIt)
+{
+  TestStepper::moveBy(SLOW_SPEED, 3);
+  ASSERT_TRUE(TestStepper::enqueue(TestStepper::MovementSpec::distance(-SLOW_SPEED, 5)));
+
+  runTimed();
+  expectIdleState(-2);
+}
+
+TEST_F(StepperQueueTest, EnqueueRejectsZeroStepsAndFullQueue)
+{
+  EXPECT_FALSE(TestStepper::enqueue(TestStepper::MovementSpec::distance(SLOW_SPEED, 0)));
+
+  for (int i = 0; i < STEPPER_QUEUE_SIZE; i++)
+  {
+    ASSERT_TRUE(TestStepper::enqueue(TestStepper::MovementSpec::distance(SLOW_SPEED, 1)));
+  }
+  EXPECT_FALSE(TestStepper::enqueue(TestStepper::MovementSpec::distance(SLOW_SPEED, 1)));
+  EXPECT_EQ(static_cast<size_t>(STEPPER_QUEUE_SIZE), TestStepper::queuedSegments());
+}
+
+TEST_F(StepperQueueTest, MoveAndTerminateDiscardQueuedSegments)
+{
+  ASSERT_TRUE(TestStepper::enqueue(TestStepper::MovementSpec::distance(FAST_SPEED, LONG_SEGMENT_STEPS)));
+  ASSERT_TRUE(TestStepper::enqueue(TestStepper::MovementSpec::distance(FAST_SPEED, LONG_SEGMENT_STEPS)));
+
+  TestStepper::moveBy(SLOW_SPEED, 2);
+  EXPECT_EQ(0U, TestStepper::queuedSegments());
+  runTimed();
+  expectIdleState(2);
+
+  ASSERT_TRUE(TestStepper::enqueue(TestStepper::MovementSpec::distance(FAST_SPEED, LONG_SEGMENT_STEPS)));
+  TestStepper::terminate();
+  EXPECT_EQ(0U, TestStepper::queuedSegments());
+  expectIdleState(2);
+}
@@ -0,0 +1,163 @@
+#include <vector>
+
+#include "RampSet.h"
+#include "StepperTestSupport.h"
+
+using ::testing::_;
+using ::testing::AnyNumber;
+
+namespace
+{
+/// Fast profile, identical to the shared test ramp.
+using Slew = AccelerationRamp<256, F_CPU, 40352, 40352>;
+/// Slow profile with a low top speed and a few coarse stairs.
+using Track = AccelerationRamp<32, F_CPU, 4000, 2000>;
+
+using Ramps = RampSet<Slew, Track>;
+using SetStepper = Stepper<Interrupt, Driver, Ramps>;
+
+constexpr uint8_t SLEW = 0;
+constexpr uint8_t TRACK = 1;
+
+/// Intervals the simulated timer was programmed with, in call order.
+std::vector<uint32_t> intervals;
+} // namespace
+
+TEST(RampSetTest, DispatchesToProfile)
+{
+  EXPECT_EQ(2, Ramps::PROFILES);
+
+  EXPECT_EQ(Slew::interval(5), Ramps::interval(SLEW, 5));
+  EXPECT_EQ(Track::interval(5), Ramps::interval(TRACK, 5));
+  EXPECT_EQ(Slew::STEPS_PER_STAIR, Ramps::stepsPerStair(SLEW));
+  EXPECT_EQ(Track::STEPS_PER_STAIR, Ramps::stepsPerStair(TRACK));
+
+  EXPECT_EQ(Slew::STAIRS_COUNT - 1, Ramps::topStair(SLEW));
+  EXPECT_EQ(Track::STAIRS_COUNT - 1, Ramps::topStair(TRACK));
+  EXPECT_EQ(Track::maxAccelStairsForInterval(8000), Ramps::stairForInterval(TRACK, 8000));
+
+  // the non-indexed functions use the first profile
+  EXPECT_EQ(Slew::getIntervalForSpeed(1234.0f), Ramps::getIntervalForSpeed(1234.0f));
+  EXPECT_EQ(Slew::maxAccelStairs(1234.0f), Ramps::maxAccelStairs(1234.0f));
+}
+
+struct StepperRampSetTest : public StepperBehaviorTestBase
+{
+protected:
+  void SetUp() override
+  {
+    StepperBehaviorTestBase::SetUp();
+
+    intervals.clear();
+
+    ON_CALL(*Interrupt::mock, setInterval(_)).WillByDefault([](const uint32_t value) { intervals.push_back(value); });
+
+    EXPECT_CALL(*Interrupt::mock, stop()).Times(AnyNumber());
+    EXPECT_CALL(*Interrupt::mock, setInterval(_)).Times(AnyNumber());
+    EXPECT_CALL(*Driver::mock, step()).Times(AnyNumber());
+    EXPECT_CALL(*Driver::mock, dir(_)).Times(AnyNumber());
+  }
+
+  void TearDown() override
+  {
+    SetStepper::reset();
+
+    StepperBehaviorTestBase::TearDown();
+  }
+
+  /**
+   * @brief Run `steps` callbacks and assert that the stepper never stops in between.
+   */
+  static void runWithoutStop(const uint32_t steps)
+  {
+    for (uint32_t i = 0; i < steps; i++)
+    {
+      ASSERT_NE(nullptr, Interrupt::mock->callback) << i;
+      Interrupt::mock->callback();
+    }
+  }
+};
+
+// Switching to a faster profile continues from the current speed and keeps accelerating.
+TEST_F(StepperRampSetTest, TrackToSlewKeepsMoving)
+{
+  SetStepper::move<TRACK>(1000.0f);
+  runWithoutStop(2000);
+  EXPECT_EQ(TRACK, SetStepper::activeProfile());
+  EXPECT_EQ(Track::getIntervalForSpeed(1000.0f), intervals.back());
+
+  const int32_t position = SetStepper::getPosition();
+  intervals.clear();
+
+  SetStepper::move(20000.0f);
+  runWithoutStop(40000);
+
+  EXPECT_EQ(SLEW, SetStepper::activeProfile());
+  EXPECT_GT(SetStepper::getPosition(), position + 38000);
+  EXPECT_EQ(Slew::getIntervalForSpeed(20000.0f), intervals.back());
+
+  // the speed only ever increases, there is no dip back to standstill
+  for (size_t i = 1; i < intervals.size(); i++)
+  {
+    EXPECT_LE(intervals[i], intervals[i - 1]) << i;
+  }
+}
+
+// Switching to a profile that can not run as fast first decelerates on the active profile.
+TEST_F(StepperRampSetTest, SlewToTrackDeceleratesFirst)
+{
+  SetStepper::move(20000.0f);
+  runWithoutStop(40000);
+  intervals.clear();
+
+  SetStepper::move<TRACK>(1000.0f);
+  runWithoutStop(20000);
+
+  EXPECT_EQ(TRACK, SetStepper::activeProfile());
+  EXPECT_EQ(Track::getIntervalForSpeed(1000.0f), intervals.back());
+  EXPECT_EQ(0U, SetStepper::queuedSegments());
+
+  // the speed only ever decreases down to the tracking rate
+  for (size_t i = 1; i < intervals.size(); i++)
+  {
+    EXPECT_GE(intervals[i], intervals[i - 1]) << i;
+  }
+}
+
+TEST_F(StepperRampSetTest, MovesOnProfileReachTheirTargets)
+{
+  SetStepper::moveTo<TRACK>(2000.0f, 5000);
+  runInterruptSteps(UINT32_MAX);
+  EXPECT_EQ(5000, SetStepper::getPosition());
+  EXPECT_FALSE(SetStepper::isRunning());
+
+  SetStepper::moveBy<SLEW>(-20000.0f, 30000);
+  runInterruptSteps(UINT32_MAX);
+  EXPECT_EQ(-25000, SetStepper::getPosition());
+
+  // a target behind the point where the slew ramp could stop reverses on the tracking profile
+  SetStepper::move(20000.0f);
+  runWithoutStop(40000);
+  const int32_t position = SetStepper::getPosition();
+  SetStepper::moveTo<TRACK>(1000.0f, position);
+  runInterruptSteps(UINT32_MAX);
+
+  EXPECT_EQ(position, SetStepper::getPosition());
+  EXPECT_EQ(position, Driver::position);
+  EXPECT_EQ(0U, SetStepper::distanceToGo());
+}
+
+// Queued segments may use different profiles, their boundary is reached at standstill.
+TEST_F(StepperRampSetTest, QueueMixesProfiles)
+{
+  EXPECT_TRUE(SetStepper::enqueue(SetStepper::MovementSpec::distance<TRACK>(1000.0f, 3000)));
+  EXPECT_TRUE(SetStepper::enqueue(SetStepper::MovementSpec::distance<SLEW>(20000.0f, 30000)));
+  EXPECT_TRUE(SetStepper::enqueue(SetStepper::MovementSpec::exact<TRACK>(-1000.5f, 3000)));
+  SetStepper::startQueue();
+
+  runInterruptSteps(UINT32_MAX);
+
+  EXPECT_EQ(30000, SetStepper::getPosition());
+  EXPECT_EQ(30000, Driver::position);
+  EXPECT_FALSE(SetStepper::isRunning());
+}
@@ -0,0 +1,142 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "IntervalInterrupt.h"
+#include "Stepper.h"
+
+#include "gtest/gtest.h"
+
+namespace
+{
+/// Interrupt backend whose handler the test calls itself, standing in for the timer.
+struct ThreadInterrupt
+{
+  constexpr static unsigned long int FREQ = F_CPU;
+
+  static std::atomic<timer_callback> callback;
+
+  static void init()
+  {
+  }
+
+  static void setCallback(const timer_callback fn)
+  {
+    callback = fn;
+  }
+
+  static void setInterval(uint32_t)
+  {
+  }
+
+  static void stop()
+  {
+    callback = nullptr;
+  }
+};
+
+std::atomic<timer_callback> ThreadInterrupt::callback{nullptr};
+
+/// Driver without side effects, the stepper state is the only thing observed.
+struct NullDriver
+{
+  constexpr static uint32_t SPR = 400 * 256;
+
+  static void init()
+  {
+  }
+
+  static void step()
+  {
+  }
+
+  static void dir(bool)
+  {
+  }
+
+  static void setInverted(bool)
+  {
+  }
+};
+
+using StressStepper = Stepper<ThreadInterrupt, NullDriver, AccelerationRamp<256, F_CPU, 40352, 40352>>;
+} // namespace
+
+struct StepperSeqLockTest : public testing::Test
+{
+protected:
+  void TearDown() override
+  {
+    StressStepper::terminate(false);
+    StressStepper::reset();
+  }
+};
+
+// A reader thread polls position and remaining distance while another thread runs the handlers.
+// Every accepted snapshot must describe one consistent moment of the move: the position never runs
+// backwards and never leaves less distance to the target than was reported as remaining.
+TEST_F(StepperSeqLockTest, ConcurrentSnapshotsAreNeverTorn)
+{
+  constexpr int32_t TARGET = INT32_MAX / 2;
+
+  StressStepper::moveTo(40000.0f, TARGET);
+
+  std::atomic<bool> done{false};
+  uint32_t reads = 0;
+  uint32_t torn = 0;
+
+  std::thread reader([&]()
+                     {
+                       int32_t last = 0;
+                       while (!done)
+                       {
+                         const int32_t position = StressStepper::getPosition();
+                         const uint32_t remaining = StressStepper::distanceToGo();
+
+                         // both calls take their own snapshot, which is fine because the remaining
+                         // distance can only shrink in between
+                         const bool backwards = position < last;
+                         const bool overshoot = static_cast<uint32_t>(TARGET - position) < remaining;
+                         torn += (backwards || overshoot) ? 1 : 0;
+
+                         last = position;
+                         reads++;
+                       } });
+
+  // run the handlers for a while, then stop in the middle of the move like an emergency stop would
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(300);
+  timer_callback handler = ThreadInterrupt::callback;
+  while (handler != nullptr && std::chrono::steady_clock::now() < deadline)
+  {
+    for (uint16_t i = 0; i < 1000 && handler != nullptr; i++)
+    {
+      handler();
+      handler = ThreadInterrupt::callback;
+    }
+  }
+  StressStepper::terminate(false);
+
+  done = true;
+  reader.join();
+
+  EXPECT_GT(StressStepper::getPosition(), 0);
+  EXPECT_GT(reads, 0U);
+  EXPECT_EQ(0U, torn) << "of " << reads << " reads";
+}
+
+// Write sections nest: a plan applied inside an outer section is only published once both are closed.
+TEST(SeqLockTest, NestedWriteSectionsPublishOnce)
+{
+  SeqLock lock;
+
+  const SeqLock::Token before = lock.readBegin();
+  lock.writeBegin();
+  lock.writeBegin();
+  lock.writeEnd();
+  EXPECT_TRUE(lock.retry(before));
+  lock.writeEnd();
+
+  const SeqLock::Token after = lock.readBegin();
+  EXPECT_EQ(before + 2, after);
+  EXPECT_FALSE(lock.retry(after));
+}
@@ -117,6 +117,7 @@ struct RelativeMovementMatrixParams
         NamedValue("Idle", 0.0f),
       NamedValue("SlowCW", SLOW_SPEED),
       NamedValue("SlowCCW", -SLOW_SPEED),
+      NamedValue("HalfFastCW", FAST_SPEED / 2),
       NamedValue("FastCW", FAST_SPEED),
       NamedValue("FastCCW", -FAST_SPEED),
     };
@@ -124,6 +125,8 @@ struct RelativeMovementMatrixParams
     const std::vector<NamedValue<float>> runSpeeds = {
       NamedValue("SlowCW", SLOW_SPEED),
       NamedValue("SlowCCW", -SLOW_SPEED),
+      NamedValue("HalfFastCW", FAST_SPEED / 2),
+      NamedValue("HalfFastCCW", -FAST_SPEED / 2),
       NamedValue("FastCW", FAST_SPEED),
       NamedValue("FastCCW", -FAST_SPEED),
     };
@@ -0,0 +1,242 @@
+#include <vector>
+
+#include "Stepper.h"
+#include "TimerMultiplexer.h"
+
+#include "gmock/gmock.h"
+#include "gmocks/MockedDriver.h"
+
+using ::testing::NiceMock;
+
+namespace
+{
+/// Simulated free-running counter. Time only advances when the test says so.
+struct FakeClock
+{
+  constexpr static uint32_t FREQ = F_CPU;
+
+  static uint32_t ticks;
+  static uint32_t deadline;
+  static bool armed;
+  static bool enabled; ///< interrupt state managed by `lock()` and `unlock()`
+
+  static void init()
+  {
+  }
+
+  static uint32_t now()
+  {
+    return ticks;
+  }
+
+  static void arm(const uint32_t value)
+  {
+    deadline = value;
+    armed = true;
+  }
+
+  static void disarm()
+  {
+    armed = false;
+  }
+
+  static uint8_t lock()
+  {
+    const uint8_t state = enabled ? 1 : 0;
+    enabled = false;
+    return state;
+  }
+
+  static void unlock(const uint8_t state)
+  {
+    enabled = (state != 0);
+  }
+};
+
+uint32_t FakeClock::ticks = 0;
+uint32_t FakeClock::deadline = 0;
+bool FakeClock::armed = false;
+bool FakeClock::enabled = true;
+
+using Mux = TimerMultiplexer<FakeClock, 3>;
+
+using DriverA = MockedDriver<4>;
+using DriverB = MockedDriver<5>;
+using RealRamp = AccelerationRamp<256, F_CPU, 40352, 40352>;
+
+using StepperA = Stepper<MultiplexedInterrupt<Mux, 0>, DriverA, RealRamp>;
+using StepperB = Stepper<MultiplexedInterrupt<Mux, 1>, DriverB, RealRamp>;
+
+std::vector<uint32_t> times_a;
+std::vector<uint32_t> times_b;
+
+/// Ticks every raw channel callback spends.
+uint32_t callback_cost = 0;
+/// Latest a raw channel callback ran after its deadline.
+uint32_t max_lateness = 0;
+uint32_t calls[3] = {};
+uint32_t expected[3] = {};
+
+constexpr uint32_t PERIOD = 1000;
+
+template <uint8_t CHANNEL>
+void rawCallback()
+{
+  const uint32_t lateness = FakeClock::ticks - expected[CHANNEL];
+  max_lateness = (lateness > max_lateness) ? lateness : max_lateness;
+
+  calls[CHANNEL]++;
+  expected[CHANNEL] += PERIOD;
+  FakeClock::ticks += callback_cost;
+}
+
+/**
+ * @brief Advance the clock from deadline to deadline until nothing is armed any more.
+ */
+void runUntilIdle(const uint32_t limit)
+{
+  for (uint32_t i = 0; i < limit && FakeClock::armed; i++)
+  {
+    if (static_cast<int32_t>(FakeClock::deadline - FakeClock::ticks) > 0)
+    {
+      FakeClock::ticks = FakeClock::deadline;
+    }
+    Mux::handle();
+  }
+}
+} // namespace
+
+struct TimerMultiplexerTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    DriverA::mock = new NiceMock<DriverMock>();
+    DriverB::mock = new NiceMock<DriverMock>();
+    DriverA::position = 0;
+    DriverB::position = 0;
+
+    ON_CALL(*DriverA::mock, step()).WillByDefault([]() { times_a.push_back(FakeClock::ticks); });
+    ON_CALL(*DriverB::mock, step()).WillByDefault([]() { times_b.push_back(FakeClock::ticks); });
+
+    // start close to the wrap of the 32-bit counter
+    FakeClock::ticks = UINT32_MAX - 5000000;
+    FakeClock::enabled = true;
+    times_a.clear();
+    times_b.clear();
+
+    MultiplexedInterrupt<Mux, 0>::init();
+    MultiplexedInterrupt<Mux, 1>::init();
+  }
+
+  void TearDown() override
+  {
+    StepperA::terminate(false);
+    StepperB::terminate(false);
+    StepperA::reset();
+    StepperB::reset();
+
+    delete DriverA::mock;
+    delete DriverB::mock;
+  }
+};
+
+// Two unmodified steppers share the timer and reach their targets.
+TEST_F(TimerMultiplexerTest, SteppersShareOneTimer)
+{
+  StepperA::moveTo(20000.0f, 30000);
+  StepperB::moveTo(-3000.0f, -4000);
+
+  runUntilIdle(UINT32_MAX);
+
+  EXPECT_FALSE(FakeClock::armed);
+  EXPECT_EQ(30000, StepperA::getPosition());
+  EXPECT_EQ(30000, DriverA::position);
+  EXPECT_EQ(-4000, StepperB::getPosition());
+  EXPECT_EQ(-4000, DriverB::position);
+}
+
+// Without callback cost every stepper is timed exactly as if it owned the timer alone.
+TEST_F(TimerMultiplexerTest, SharedTimingMatchesDedicatedTimer)
+{
+  const uint32_t start = FakeClock::ticks;
+  StepperA::moveTo(20000.0f, 30000);
+  runUntilIdle(UINT32_MAX);
+  std::vector<uint32_t> alone = times_a;
+  for (uint32_t &time : alone)
+  {
+    time -= start;
+  }
+
+  FakeClock::ticks = start;
+  times_a.clear();
+  StepperA::setPosition(0);
+  DriverA::position = 0;
+
+  StepperA::moveTo(20000.0f, 30000);
+  StepperB::moveTo(-3000.0f, -4000);
+  runUntilIdle(UINT32_MAX);
+
+  std::vector<uint32_t> shared = times_a;
+  for (uint32_t &time : shared)
+  {
+    time -= start;
+  }
+  EXPECT_EQ(alone, shared);
+}
+
+// Colliding deadlines are served one after another: no callback is later than the callbacks of the
+// other channels take, and the lateness does not accumulate into drift.
+TEST_F(TimerMultiplexerTest, JitterIsBoundedAndDoesNotDrift)
+{
+  constexpr uint32_t CYCLES = 1000;
+
+  callback_cost = 100;
+  max_lateness = 0;
+
+  Mux::setCallback(0, rawCallback<0>);
+  Mux::setCallback(1, rawCallback<1>);
+  Mux::setCallback(2, rawCallback<2>);
+
+  const uint32_t start = FakeClock::ticks;
+  for (uint8_t channel = 0; channel < 3; channel++)
+  {
+    calls[channel] = 0;
+    expected[channel] = start + PERIOD;
+    Mux::setInterval(channel, PERIOD);
+  }
+
+  while (FakeClock::ticks - start < CYCLES * PERIOD)
+  {
+    runUntilIdle(1);
+  }
+
+  for (uint8_t channel = 0; channel < 3; channel++)
+  {
+    Mux::stop(channel);
+    EXPECT_GE(calls[channel], CYCLES - 1);
+    EXPECT_LE(calls[channel], CYCLES + 1);
+  }
+  EXPECT_LE(max_lateness, 2 * callback_cost);
+  EXPECT_GT(max_lateness, 0U);
+  EXPECT_FALSE(FakeClock::armed);
+}
+
+// Called with interrupts disabled, e.g. from the commit of a stepper, the channel leaves them so.
+TEST_F(TimerMultiplexerTest, KeepsTheCallersInterruptState)
+{
+  Mux::setCallback(2, rawCallback<2>);
+
+  FakeClock::enabled = false;
+  Mux::setInterval(2, PERIOD);
+  EXPECT_FALSE(FakeClock::enabled);
+  Mux::stop(2);
+  EXPECT_FALSE(FakeClock::enabled);
+
+  FakeClock::enabled = true;
+  Mux::setInterval(2, PERIOD);
+  EXPECT_TRUE(FakeClock::enabled);
+  Mux::stop(2);
+  EXPECT_TRUE(FakeClock::enabled);
+  EXPECT_FALSE(FakeClock::armed);
+}
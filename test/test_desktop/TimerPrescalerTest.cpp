@@ -0,0 +1,127 @@
+#include "TimerPrescaler.h"
+
+#include "gtest/gtest.h"
+
+using internal::PrescaledInterval;
+using internal::TimerPrescaler;
+
+namespace
+{
+/// CPU cycles of a programmed interval.
+uint64_t cycles(const PrescaledInterval &interval)
+{
+  return ((static_cast<uint64_t>(interval.ovf) << 16) + interval.ocr + 1) << interval.shift;
+}
+
+/// Interrupts the timer raises for one interval: the overflows and the compare match.
+uint32_t interrupts(const PrescaledInterval &interval)
+{
+  return interval.ovf + 1U;
+}
+
+/// Interrupts per interval on a timer fixed at prescaler 1.
+uint32_t interruptsWithoutPrescaler(const uint32_t cycles)
+{
+  return ((cycles - 1) >> 16) + 1;
+}
+} // namespace
+
+TEST(TimerPrescalerTest, SelectsSmallestFittingPrescaler)
+{
+  EXPECT_EQ(0, TimerPrescaler::select(1));
+  EXPECT_EQ(0, TimerPrescaler::select(0x10000));
+  EXPECT_EQ(1, TimerPrescaler::select(0x10001));
+  EXPECT_EQ(1, TimerPrescaler::select(0x80000));
+  EXPECT_EQ(2, TimerPrescaler::select(0x80001));
+  EXPECT_EQ(3, TimerPrescaler::select(0x400001));
+  EXPECT_EQ(4, TimerPrescaler::select(0x1000001));
+  EXPECT_EQ(4, TimerPrescaler::select(0x4000001));
+}
+
+// Intervals that fit 16 bits keep prescaler 1 and the exact compare value.
+TEST(TimerPrescalerTest, ShortIntervalsStayOnPrescalerOne)
+{
+  bool exact = true;
+  for (uint32_t value = 1; value <= 0x10000; value++)
+  {
+    uint16_t residue = 0;
+    const PrescaledInterval interval = TimerPrescaler::split(value, residue);
+    exact = exact && interval.cs == 1 && interval.ovf == 0 && interval.ocr == value - 1 && residue == 0;
+  }
+  EXPECT_TRUE(exact);
+}
+
+// Every step edge lands less than one prescaled tick before its ideal time, also while the timer
+// repeats an interval in CTC mode without a new setInterval(). Like the AVR backend, the model splits
+// a repeat again if the split before took a different residue than it left, and otherwise lets the
+// timer repeat the compare value.
+TEST(TimerPrescalerTest, EdgesStayWithinOnePrescaledTick)
+{
+  uint16_t residue = 0;
+  uint64_t requested = 0;
+  uint64_t programmed = 0;
+  uint32_t state = 1;
+  uint32_t repeats = 0;
+  bool within = true;
+
+  for (uint32_t i = 0; i < 100000; i++)
+  {
+    state = state * 1103515245U + 12345U;
+    const uint32_t value = 1 + ((state >> (state % 24)) & 0x0FFFFFFF);
+
+    PrescaledInterval interval{};
+    bool carries = true;
+    for (uint32_t repeat = 0; repeat <= ((state >> 28) & 7U); repeat++)
+    {
+      if (carries)
+      {
+        const uint16_t carried = residue;
+        interval = TimerPrescaler::split(value, residue);
+        carries = residue != carried;
+      }
+      repeats += repeat > 0 ? 1 : 0;
+
+      requested += value;
+      programmed += cycles(interval);
+
+      within = within && requested - programmed == residue && residue < (1U << interval.shift);
+    }
+  }
+
+  EXPECT_GT(repeats, 100000U);
+  EXPECT_TRUE(within);
+}
+
+// Only intervals beyond the range of prescaler 1024 still count overflows.
+TEST(TimerPrescalerTest, OverflowsOnlyBeyondLargestPrescaler)
+{
+  uint16_t residue = 0;
+  EXPECT_EQ(0, TimerPrescaler::split(1024UL * 0x10000, residue).ovf);
+  EXPECT_EQ(5, TimerPrescaler::split(1024UL * 0x10000, residue).cs);
+
+  residue = 0;
+  const PrescaledInterval interval = TimerPrescaler::split(1024UL * 0x10000 * 3, residue);
+  EXPECT_EQ(2, interval.ovf);
+  EXPECT_EQ(1024ULL * 0x10000 * 3, cycles(interval));
+}
+
+// Sidereal tracking of a 400 step motor at 16 microsteps behind a 1:144 worm, 10.7 steps/s at 16 MHz.
+TEST(TimerPrescalerTest, TrackingSavesOverflowInterrupts)
+{
+  const double steps_per_second = 400.0 * 16 * 144 / 86164.0905;
+  const auto interval = static_cast<uint32_t>(F_CPU / steps_per_second);
+
+  uint16_t residue = 0;
+  const PrescaledInterval prescaled = TimerPrescaler::split(interval, residue);
+
+  const double before = interruptsWithoutPrescaler(interval) * steps_per_second;
+  const double after = interrupts(prescaled) * steps_per_second;
+  RecordProperty("isr_per_second_fixed_prescaler", static_cast<int>(before));
+  RecordProperty("isr_per_second_selected_prescaler", static_cast<int>(after));
+  RecordProperty("isr_per_second_saved", static_cast<int>(before - after));
+
+  EXPECT_EQ(3, prescaled.cs); // prescaler 64
+  EXPECT_EQ(1U, interrupts(prescaled));
+  EXPECT_EQ(23U, interruptsWithoutPrescaler(interval));
+  EXPECT_GT(before - after, 230.0);
+}
@@ -11,6 +11,10 @@ public:
     MOCK_METHOD(uint32_t, setCallback, (timer_callback));
     MOCK_METHOD(uint32_t, getIntervalForSpeed, (float));
     MOCK_METHOD(uint8_t, maxAccelStairs, (float));
+    MOCK_METHOD(uint32_t, getIntervalForFixedSpeed, (FixedSpeed));
+    MOCK_METHOD(uint16_t, maxAccelStairsForInterval, (uint32_t));
+    MOCK_METHOD(uint16_t, getIntervalFractionForSpeed, (float));
+    MOCK_METHOD(uint16_t, getIntervalFractionForFixedSpeed, (FixedSpeed));
 
     virtual ~RampMock() = default;
 
@@ -21,12 +25,24 @@ public:
         ON_CALL(*this, getIntervalForSpeed).WillByDefault([](float sps) { return T_REAL::getIntervalForSpeed(sps); });
 
         ON_CALL(*this, maxAccelStairs).WillByDefault([](float radPerSec) { return T_REAL::maxAccelStairs(radPerSec); });
+
+        ON_CALL(*this, getIntervalForFixedSpeed).WillByDefault([](FixedSpeed speed) { return T_REAL::getIntervalForSpeed(speed); });
+
+        ON_CALL(*this, maxAccelStairsForInterval).WillByDefault([](uint32_t interval) { return T_REAL::maxAccelStairsForInterval(interval); });
+
+        ON_CALL(*this, getIntervalFractionForSpeed).WillByDefault([](float sps) { return T_REAL::getIntervalFractionForSpeed(sps); });
+
+        ON_CALL(*this, getIntervalFractionForFixedSpeed).WillByDefault([](FixedSpeed speed) { return T_REAL::getIntervalFractionForSpeed(speed); });
     }
 
     template<typename T_REAL>
     void expectLimits() {
         EXPECT_CALL(*this, getIntervalForSpeed(_)).Times(AnyNumber());
         EXPECT_CALL(*this, maxAccelStairs(_)).Times(AnyNumber());
+        EXPECT_CALL(*this, getIntervalForFixedSpeed(_)).Times(AnyNumber());
+        EXPECT_CALL(*this, maxAccelStairsForInterval(_)).Times(AnyNumber());
+        EXPECT_CALL(*this, getIntervalFractionForSpeed(_)).Times(AnyNumber());
+        EXPECT_CALL(*this, getIntervalFractionForFixedSpeed(_)).Times(AnyNumber());
         EXPECT_CALL(*this, interval(_)).Times(AnyNumber());
         EXPECT_CALL(*this, interval(0)).Times(0);
         EXPECT_CALL(*this, interval(Ge(T_REAL::STAIRS_COUNT))).Times(0);
@@ -63,6 +79,22 @@ struct MockedAccelerationRamp {
     static uint16_t maxAccelStairs(float radPerSec) {
         return mock->maxAccelStairs(radPerSec);
     }
+
+    static uint32_t getIntervalForSpeed(FixedSpeed speed) {
+        return mock->getIntervalForFixedSpeed(speed);
+    }
+
+    static uint16_t maxAccelStairsForInterval(uint32_t interval) {
+        return mock->maxAccelStairsForInterval(interval);
+    }
+
+    static uint16_t getIntervalFractionForSpeed(float sps) {
+        return mock->getIntervalFractionForSpeed(sps);
+    }
+
+    static uint16_t getIntervalFractionForSpeed(FixedSpeed speed) {
+        return mock->getIntervalFractionForFixedSpeed(speed);
+    }
 };
 
 template<uint16_t T_STAIRS, uint32_t T_FREQ, uint32_t T_MAX_SPEED, uint32_t T_ACCELERATION>
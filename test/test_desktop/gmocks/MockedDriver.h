@@ -9,16 +9,19 @@ struct DriverMock
     MOCK_METHOD(void, dir, (bool));
 };
 
-template<uint32_t T_SPR>
+template<uint32_t T_SPR, bool T_DUAL_EDGE = false>
 struct MockedDriver
 {
     constexpr static auto SPR = T_SPR;
 
+    constexpr static bool DUAL_EDGE = T_DUAL_EDGE;
+
     static DriverMock *mock;
 
     static bool inverted;
     static bool direction;
     static int32_t position;
+    static bool level; ///< Step pin level of a dual-edge driver, toggled by every step.
 
     static void setInverted(bool value)
     {
@@ -28,6 +31,7 @@ struct MockedDriver
     static void step()
     {
         position += direction ? 1 : -1;
+        level = !level;
         mock->step();
     }
 
@@ -38,14 +42,17 @@ struct MockedDriver
     }
 };
 
-template<uint32_t T_SPR>
-DriverMock* MockedDriver<T_SPR>::mock = nullptr;
+template<uint32_t T_SPR, bool T_DUAL_EDGE>
+DriverMock* MockedDriver<T_SPR, T_DUAL_EDGE>::mock = nullptr;
+
+template<uint32_t T_SPR, bool T_DUAL_EDGE>
+bool MockedDriver<T_SPR, T_DUAL_EDGE>::inverted = false;
 
-template<uint32_t T_SPR>
-bool MockedDriver<T_SPR>::inverted = false;
+template<uint32_t T_SPR, bool T_DUAL_EDGE>
+bool MockedDriver<T_SPR, T_DUAL_EDGE>::direction = false;
 
-template<uint32_t T_SPR>
-bool MockedDriver<T_SPR>::direction = false;
+template<uint32_t T_SPR, bool T_DUAL_EDGE>
+int32_t MockedDriver<T_SPR, T_DUAL_EDGE>::position = 0;
 
-template<uint32_t T_SPR>
-int32_t MockedDriver<T_SPR>::position = 0;
\ No newline at end of file
+template<uint32_t T_SPR, bool T_DUAL_EDGE>
+bool MockedDriver<T_SPR, T_DUAL_EDGE>::level = false;
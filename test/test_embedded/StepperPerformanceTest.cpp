@@ -51,6 +51,18 @@
 #define STEPPER_PERF_MIN_STEADY_STEPS_PER_SEC 0UL
 #endif
 
+#ifndef STEPPER_PERF_COALESCE_SPEED
+#define STEPPER_PERF_COALESCE_SPEED 0UL
+#endif
+
+#ifndef STEPPER_PERF_COALESCE_BURST
+#define STEPPER_PERF_COALESCE_BURST 4U
+#endif
+
+#ifndef STEPPER_PERF_SNAPSHOT_CALLS
+#define STEPPER_PERF_SNAPSHOT_CALLS 1000UL
+#endif
+
 namespace
 {
 using PerformanceInterrupt = IntervalInterrupt<Timer::TIMER_3>;
@@ -59,7 +71,9 @@ using PerformanceRamp = AccelerationRamp<
     STEPPER_PERF_RAMP_STAIRS,
     PerformanceInterrupt::FREQ,
     static_cast<uint32_t>(STEPPER_PERF_TARGET_SPS),
-    static_cast<uint32_t>(STEPPER_PERF_ACCELERATION)>;
+    static_cast<uint32_t>(STEPPER_PERF_ACCELERATION),
+    static_cast<uint32_t>(STEPPER_PERF_COALESCE_SPEED),
+    static_cast<uint8_t>(STEPPER_PERF_COALESCE_BURST)>;
 using PerformanceStepper = Stepper<PerformanceInterrupt, PerformanceDriver, PerformanceRamp>;
 
 struct PerformanceMeasurement
@@ -113,6 +127,27 @@ PerformanceMeasurement measureSteadyStateStepRate()
     return {elapsed_us, steps, achieved_steps_per_second};
 }
 
+/**
+ * Time one state snapshot on an idle stepper, in nanoseconds. Before snapshots were guarded by a
+ * sequence counter, interrupts stayed masked for this whole copy on every getPosition() and
+ * distanceToGo() call, so this is the step latency the main loop no longer adds.
+ */
+uint32_t measureSnapshotCopyNanos()
+{
+    PerformanceStepper::terminate(false);
+    PerformanceStepper::reset();
+
+    volatile int32_t sink = 0;
+    const uint32_t start_us = micros();
+    for (uint32_t i = 0; i < STEPPER_PERF_SNAPSHOT_CALLS; i++)
+    {
+        sink = sink + PerformanceStepper::getPosition();
+    }
+    const uint32_t elapsed_us = micros() - start_us;
+
+    return static_cast<uint32_t>((static_cast<uint64_t>(elapsed_us) * 1000ULL) / STEPPER_PERF_SNAPSHOT_CALLS);
+}
+
 void printMeasurement(const PerformanceMeasurement &measurement)
 {
     Serial.print(F("[ PERF ] steady-state target: "));
@@ -146,8 +181,20 @@ void test_stepper_reports_steady_state_step_rate_on_avr()
     }
 }
 
+void test_stepper_reports_snapshot_copy_time_on_avr()
+{
+    const uint32_t copy_ns = measureSnapshotCopyNanos();
+
+    Serial.print(F("[ PERF ] snapshot copy: "));
+    Serial.print(copy_ns);
+    Serial.println(F(" ns per getPosition(), no longer spent with interrupts masked"));
+
+    TEST_ASSERT_GREATER_THAN_UINT32(0U, copy_ns);
+}
+
 void runStepperPerformanceTest()
 {
     UnitySetTestFile(__FILE__);
     RUN_TEST(test_stepper_reports_steady_state_step_rate_on_avr);
+    RUN_TEST(test_stepper_reports_snapshot_copy_time_on_avr);
 }
\ No newline at end of file